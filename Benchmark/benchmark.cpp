@@ -0,0 +1,212 @@
+// Benchmark do K-means sobre blobs gaussianos sintéticos. Compilação, a partir da raiz do projeto:
+//
+//   g++ -O2 -I. $(ls *.cpp | grep -v main.cpp) Benchmark/benchmark.cpp -o benchmark_kmeans
+//
+// Uso: ./benchmark_kmeans [rapido|completo] [arquivo.jsonl]
+//
+// Cada configuração da grade gera uma linha JSON (no arquivo, ou na saída padrão) com a vazão em
+// pontos x iterações por segundo, a eficiência de escalonamento em relação a uma thread, o pico
+// de memória residente e os índices de validação.
+
+#include "../Library/kmeans.h"
+#include "../Library/sintetico.h"
+#include "../Library/hierarquico.h"
+#include "../Library/esparso.h"
+#include "../Library/quantizado.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <functional>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+struct Cenario {
+    size_t numInstancias;
+    size_t dimensao;
+    int K;
+    double desequilibrio;
+};
+
+// Representação da base de cada backend; numThreads só se aplica ao denso (0 = todas)
+static unique_ptr<DadosAtribuicao> criarBackend(const string& backend, const vector<Instancia>& instancias, size_t numThreads) {
+    if (backend == "esparso") {
+        return make_unique<DadosEsparsos>(DadosEsparsos::deInstancias(instancias));
+    }
+    if (backend == "quantizado8") {
+        return make_unique<DadosQuantizados>(instancias, 8);
+    }
+    if (backend == "quantizado16") {
+        return make_unique<DadosQuantizados>(instancias, 16);
+    }
+    return make_unique<DadosNuma>(instancias, TopologiaNuma::detectar(), numThreads);
+}
+
+// Zera o pico de memória residente do processo (Linux >= 4.0), para medir cada configuração
+static void reiniciarPicoMemoria() {
+#ifdef __linux__
+    ofstream arquivo("/proc/self/clear_refs");
+    if (arquivo.is_open()) {
+        arquivo << "5";
+    }
+#endif
+}
+
+// Pico de memória residente em KB (VmHWM; ru_maxrss quando /proc não está disponível)
+static long picoMemoriaKb() {
+#ifdef __linux__
+    ifstream arquivo("/proc/self/status");
+    string linha;
+    while (getline(arquivo, linha)) {
+        if (linha.rfind("VmHWM:", 0) == 0) {
+            return stol(linha.substr(6));
+        }
+    }
+    rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_maxrss;
+#else
+    return -1;
+#endif
+}
+
+static double segundosDesde(chrono::steady_clock::time_point inicio) {
+    return chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+}
+
+int main(int argc, char** argv) {
+    string grade = argc > 1 ? argv[1] : "rapido";
+    ofstream arquivo;
+    if (argc > 2) {
+        arquivo.open(argv[2]);
+        if (!arquivo.is_open()) {
+            cerr << "Erro ao abrir o arquivo: " << argv[2] << endl;
+            return 1;
+        }
+    }
+    ostream& saida = arquivo.is_open() ? arquivo : cout;
+
+    vector<Cenario> cenarios;
+    if (grade == "completo") {
+        for (size_t n : {100000, 1000000}) {
+            for (size_t d : {16, 64}) {
+                for (int K : {8, 32, 128}) {
+                    cenarios.push_back({n, d, K, 0.0});
+                }
+            }
+        }
+        cenarios.push_back({1000000, 16, 32, 1.0});
+    } else {
+        for (size_t n : {10000, 100000}) {
+            for (int K : {8, 32}) {
+                cenarios.push_back({n, 16, K, 0.0});
+            }
+        }
+        cenarios.push_back({100000, 16, 32, 1.0});
+    }
+
+    const vector<string> backends = {"denso", "esparso", "quantizado8", "quantizado16"};
+    const vector<string> inicializacoes = {"aleatorio", "hierarquico"};
+    const uint64_t semente = 42;
+    // A silhueta é quadrática no tamanho dos clusters
+    const size_t limiteSilhueta = 20000;
+
+    size_t maxThreads = max(1u, thread::hardware_concurrency());
+    vector<size_t> contagensThreads;
+    for (size_t t = 1; t < maxThreads; t *= 2) {
+        contagensThreads.push_back(t);
+    }
+    contagensThreads.push_back(maxThreads);
+
+    CriterioParada parada;
+    parada.maxIteracoes = 20;
+
+    for (const Cenario& cenario : cenarios) {
+        ParametrosBlobs parametros;
+        parametros.numInstancias = cenario.numInstancias;
+        parametros.dimensao = cenario.dimensao;
+        parametros.numClusters = cenario.K;
+        parametros.desequilibrio = cenario.desequilibrio;
+        parametros.semente = semente;
+
+        auto inicioGeracao = chrono::steady_clock::now();
+        vector<Instancia> instancias = GeradorBlobs(parametros).gerarTodas();
+        double segundosGeracao = segundosDesde(inicioGeracao);
+        cerr << "n=" << cenario.numInstancias << " d=" << cenario.dimensao << " K=" << cenario.K
+             << " desequilibrio=" << cenario.desequilibrio << " (gerada em " << segundosGeracao << " s)" << endl;
+
+        // Uma execução: backend, inicialização e número de threads do kernel denso
+        auto executar = [&](const string& backend, const string& inicializacao, size_t numThreads, bool indices, double vazaoUmaThread) {
+            reiniciarPicoMemoria();
+            auto inicio = chrono::steady_clock::now();
+
+            unique_ptr<DadosAtribuicao> dados = criarBackend(backend, instancias, numThreads);
+            vector<Centroide> centroides;
+            if (inicializacao == "hierarquico") {
+                centroides = ArvoreKmeans::construir(instancias, cenario.K, 2, semente).getCentroides();
+            } else {
+                centroides = criarCentroidesAleatorios(cenario.K, instancias, semente);
+            }
+            double segundosInicializacao = segundosDesde(inicio);
+
+            auto inicioLloyd = chrono::steady_clock::now();
+            Atribuicao atribuicao;
+            int iteracoes = executarLloyd(centroides, instancias, *dados, atribuicao, semente, VAZIO_ROUBAR_MAIS_DISTANTE, parada);
+            double segundosLloyd = segundosDesde(inicioLloyd);
+            // Passada inicial mais as iterações
+            double vazao = (double) instancias.size() * (iteracoes + 1) / segundosLloyd;
+
+            ostringstream linha;
+            linha << setprecision(6) << "{\"n\":" << cenario.numInstancias << ",\"d\":" << cenario.dimensao
+                  << ",\"K\":" << cenario.K << ",\"desequilibrio\":" << cenario.desequilibrio
+                  << ",\"backend\":\"" << backend << "\",\"inicializacao\":\"" << inicializacao << "\""
+                  << ",\"threads\":" << (numThreads == 0 ? maxThreads : numThreads)
+                  << ",\"iteracoes\":" << iteracoes << ",\"segundos_inicializacao\":" << segundosInicializacao
+                  << ",\"segundos_lloyd\":" << segundosLloyd << ",\"pontos_iteracoes_por_s\":" << vazao
+                  << ",\"inercia\":" << atribuicao.inercia;
+            if (numThreads == 1) {
+                linha << ",\"eficiencia\":1";
+            } else if (vazaoUmaThread > 0.0) {
+                linha << ",\"eficiencia\":" << vazao / (vazaoUmaThread * numThreads);
+            }
+
+            if (indices) {
+                auto inicioIndices = chrono::steady_clock::now();
+                calcularCentroidesProximos(centroides, instancias, *dados, atribuicao, 0);
+                linha << ",\"davies_bouldin\":" << daviesBouldin(centroides)
+                      << ",\"calinski_harabasz\":" << calinskiHarabasz(centroides, instancias);
+                if (instancias.size() <= limiteSilhueta) {
+                    linha << ",\"silhouette\":" << silhouetteMeasure(centroides);
+                }
+                linha << ",\"segundos_indices\":" << segundosDesde(inicioIndices);
+            }
+
+            linha << ",\"rss_pico_kb\":" << picoMemoriaKb() << "}";
+            saida << linha.str() << endl;
+            return vazao;
+        };
+
+        for (const string& backend : backends) {
+            for (const string& inicializacao : inicializacoes) {
+                executar(backend, inicializacao, 0, backend == "denso" && inicializacao == "aleatorio", 0.0);
+            }
+        }
+
+        // Escalonamento do kernel denso, o único com número de threads configurável
+        double vazaoUmaThread = 0.0;
+        for (size_t numThreads : contagensThreads) {
+            double vazao = executar("denso", "aleatorio", numThreads, false, vazaoUmaThread);
+            if (numThreads == 1) {
+                vazaoUmaThread = vazao;
+            }
+        }
+    }
+
+    return 0;
+}
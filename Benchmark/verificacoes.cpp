@@ -0,0 +1,499 @@
+// Verificações de regressão das garantias de correção do projeto (persistência do modelo, backends
+// de atribuição, warm start, pontos de controle e leitura em pipeline). Compilação, a partir da raiz
+// do projeto:
+//
+//   g++ -O2 -I. $(ls *.cpp | grep -v main.cpp) Benchmark/verificacoes.cpp -o verificacoes_kmeans
+//
+// Uso: ./verificacoes_kmeans [nome ...]
+//
+// Sem argumentos roda todas as verificações. Cada uma imprime OK ou FALHA com o motivo, e o código
+// de saída é 1 se alguma falhar. Os arquivos intermediários ficam no diretório temporário do sistema.
+
+#include "../Library/kmeans.h"
+#include "../Library/sintetico.h"
+#include "../Library/modelo.h"
+#include "../Library/esparso.h"
+#include "../Library/quantizado.h"
+#include "../Library/carga.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <filesystem>
+#include <functional>
+#include <set>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+static string caminhoTemporario(const string& nome) {
+    return (filesystem::temp_directory_path() / ("verificacoes_kmeans_" + nome)).string();
+}
+
+static vector<Instancia> gerarBlobs(size_t numInstancias, size_t dimensao, int K, double separacao, double desequilibrio, uint64_t semente) {
+    ParametrosBlobs parametros;
+    parametros.numInstancias = numInstancias;
+    parametros.dimensao = dimensao;
+    parametros.numClusters = K;
+    parametros.separacao = separacao;
+    parametros.desequilibrio = desequilibrio;
+    parametros.semente = semente;
+    return GeradorBlobs(parametros).gerarTodas();
+}
+
+// Zera três de cada quatro atributos, em posições que variam por instância
+static void esparsificar(vector<Instancia>& instancias) {
+    for (size_t i = 0; i < instancias.size(); ++i) {
+        vector<double> atributos = instancias[i].getAtributos();
+        for (size_t j = 0; j < atributos.size(); ++j) {
+            if ((i + j) % 4 != 0) {
+                atributos[j] = 0.0;
+            }
+        }
+        instancias[i].setAtributos(atributos);
+    }
+}
+
+// Vazio se os vetores são iguais (diferença relativa até tolerancia); senão, a primeira diferença
+template <typename T>
+static string compararVetores(const string& nome, const vector<T>& esperado, const vector<T>& obtido, double tolerancia = 0.0) {
+    ostringstream motivo;
+    motivo << setprecision(17);
+    if (esperado.size() != obtido.size()) {
+        motivo << nome << " com " << obtido.size() << " valores, esperados " << esperado.size();
+        return motivo.str();
+    }
+    for (size_t i = 0; i < esperado.size(); ++i) {
+        double a = esperado[i], b = obtido[i];
+        if (a == b || fabs(a - b) <= tolerancia * max(fabs(a), fabs(b))) continue;
+        motivo << nome << "[" << i << "] = " << b << ", esperado " << a;
+        return motivo.str();
+    }
+    return "";
+}
+
+// Modelo: salvar e carregar em FLOAT64 devolve o mesmo modelo; em FLOAT32, os centroides
+// arredondados para float. Em ambos, predizer dá os rótulos do Lloyd, e um arquivo truncado é recusado.
+static string verificarModeloIdaEVolta() {
+    vector<Instancia> instancias = gerarBlobs(4000, 8, 6, 8.0, 0.5, 3);
+    DadosNuma dados(instancias, TopologiaNuma::detectar());
+    vector<Centroide> centroides = criarCentroidesAleatorios(6, instancias, 3);
+    Atribuicao atribuicao;
+    executarLloyd(centroides, instancias, dados, atribuicao, 3, VAZIO_ROUBAR_MAIS_DISTANTE);
+    calcularCentroidesProximos(centroides, instancias, dados, atribuicao, 0);
+
+    Modelo modelo(centroides, instancias.size(), calcularInercia(centroides));
+    string motivo = compararVetores("predizer", atribuicao.rotulos, modelo.predizer(instancias));
+    if (!motivo.empty()) return motivo;
+
+    const string caminho = caminhoTemporario("modelo.bin");
+    for (Modelo::TipoDados tipo : {Modelo::FLOAT64, Modelo::FLOAT32}) {
+        if (!modelo.salvar(caminho, tipo)) return "salvar falhou";
+        Modelo carregado = Modelo::carregar(caminho);
+        string sufixo = tipo == Modelo::FLOAT32 ? " (FLOAT32)" : "";
+
+        if (carregado.getNumCentroides() != modelo.getNumCentroides() || carregado.getDimensao() != modelo.getDimensao()
+            || carregado.getNumInstanciasTreino() != instancias.size() || carregado.getInercia() != modelo.getInercia()
+            || carregado.getDataTreino() != modelo.getDataTreino() || !carregado.temEstatisticas()) {
+            return "metadados diferentes" + sufixo;
+        }
+        vector<double> esperados = modelo.getCentroides();
+        if (tipo == Modelo::FLOAT32) {
+            for (double& valor : esperados) {
+                valor = static_cast<float>(valor);
+            }
+        } else {
+            motivo = compararVetores("normas", modelo.getNormas(), carregado.getNormas());
+            if (!motivo.empty()) return motivo;
+        }
+        motivo = compararVetores("centroides" + sufixo, esperados, carregado.getCentroides());
+        if (motivo.empty()) motivo = compararVetores("massas" + sufixo, modelo.getMassas(), carregado.getMassas());
+        if (motivo.empty()) motivo = compararVetores("predizer" + sufixo, atribuicao.rotulos, carregado.predizer(instancias));
+        if (!motivo.empty()) return motivo;
+    }
+
+    filesystem::resize_file(caminho, filesystem::file_size(caminho) - 8);
+    try {
+        Modelo::carregar(caminho);
+        return "modelo truncado foi aceito";
+    } catch (const runtime_error&) {
+    }
+    filesystem::remove(caminho);
+    return "";
+}
+
+// Lloyd completo com o backend dado, a partir dos mesmos centroides iniciais
+static int executarComBackend(DadosAtribuicao& dados, vector<Instancia>& instancias, int K, uint64_t semente, vector<Centroide>& centroides, Atribuicao& atribuicao) {
+    centroides = criarCentroidesAleatorios(K, instancias, semente);
+    return executarLloyd(centroides, instancias, dados, atribuicao, semente, VAZIO_ROUBAR_MAIS_DISTANTE);
+}
+
+static vector<double> posicoesDe(const vector<Centroide>& centroides) {
+    vector<double> posicoes;
+    for (const Centroide& centroide : centroides) {
+        const vector<double> atributos = centroide.getAtributos();
+        posicoes.insert(posicoes.end(), atributos.begin(), atributos.end());
+    }
+    return posicoes;
+}
+
+// CSR: numa base sem quase empates, o Lloyd com o backend esparso chega aos mesmos rótulos,
+// contagens e centroides (a menos do arredondamento da forma expandida) que o denso. A base
+// gravada em SVMlight e lida por lerSvmLight tem as mesmas linhas, e uma entrada inválida é recusada.
+static string verificarEsparsoDenso() {
+    vector<Instancia> instancias = gerarBlobs(5000, 32, 8, 8.0, 0.0, 5);
+    esparsificar(instancias);
+
+    DadosNuma denso(instancias, TopologiaNuma::detectar());
+    DadosEsparsos esparso = DadosEsparsos::deInstancias(instancias);
+    vector<Centroide> centroidesDensos, centroidesEsparsos;
+    Atribuicao atribuicaoDensa, atribuicaoEsparsa;
+    int iteracoesDenso = executarComBackend(denso, instancias, 8, 5, centroidesDensos, atribuicaoDensa);
+    int iteracoesEsparso = executarComBackend(esparso, instancias, 8, 5, centroidesEsparsos, atribuicaoEsparsa);
+    if (iteracoesDenso != iteracoesEsparso) {
+        return "iteracoes: " + to_string(iteracoesEsparso) + ", esperadas " + to_string(iteracoesDenso);
+    }
+    string motivo = compararVetores("rotulos", atribuicaoDensa.rotulos, atribuicaoEsparsa.rotulos);
+    if (motivo.empty()) motivo = compararVetores("contagens", atribuicaoDensa.contagens, atribuicaoEsparsa.contagens);
+    if (motivo.empty()) motivo = compararVetores("somas", atribuicaoDensa.somas, atribuicaoEsparsa.somas, 1e-12);
+    if (motivo.empty()) motivo = compararVetores("centroides", posicoesDe(centroidesDensos), posicoesDe(centroidesEsparsos), 1e-12);
+    if (!motivo.empty()) return motivo;
+
+    const string caminho = caminhoTemporario("base.svm");
+    {
+        ofstream arquivo(caminho);
+        arquivo << setprecision(17) << "# base esparsificada\n";
+        for (size_t i = 0; i < instancias.size(); ++i) {
+            const vector<double> atributos = instancias[i].getAtributos();
+            arquivo << i % 8 << " qid:1";
+            for (size_t j = 0; j < atributos.size(); ++j) {
+                if (atributos[j] != 0.0) {
+                    arquivo << ' ' << j + 1 << ':' << atributos[j];
+                }
+            }
+            arquivo << '\n';
+        }
+    }
+    DadosEsparsos lido = DadosEsparsos::lerSvmLight(caminho);
+    if (lido.getNumInstancias() != esparso.getNumInstancias() || lido.getDimensao() != esparso.getDimensao()
+        || lido.getNumNaoNulos() != esparso.getNumNaoNulos()) {
+        return "SVMlight lido com formato diferente da base";
+    }
+    for (size_t i = 0; i < instancias.size(); ++i) {
+        motivo = compararVetores("linha " + to_string(i) + " do SVMlight", instancias[i].getAtributos(), lido.getLinhaDensa(i));
+        if (!motivo.empty()) return motivo;
+    }
+
+    ofstream(caminho) << "1 1:0.5 2:0.25\n1 3:0.5 2\n";
+    try {
+        DadosEsparsos::lerSvmLight(caminho);
+        return "SVMlight invalido foi aceito";
+    } catch (const runtime_error&) {
+    }
+    filesystem::remove(caminho);
+    return "";
+}
+
+// Quantização: com a reverificação exata das margens ambíguas, o Lloyd sobre a base quantizada em 8
+// e 16 bits chega aos mesmos rótulos e contagens que o denso, inclusive em clusters sobrepostos
+// (muitos quase empates) e desequilibrados; as somas vêm dos dados originais.
+static string verificarQuantizadoDenso() {
+    for (double separacao : {8.0, 1.0}) {
+        vector<Instancia> instancias = gerarBlobs(6000, 24, 10, separacao, 1.0, 7);
+        DadosNuma denso(instancias, TopologiaNuma::detectar());
+        vector<Centroide> centroidesDensos;
+        Atribuicao atribuicaoDensa;
+        int iteracoesDenso = executarComBackend(denso, instancias, 10, 7, centroidesDensos, atribuicaoDensa);
+
+        for (int bits : {8, 16}) {
+            DadosQuantizados quantizado(instancias, bits);
+            vector<Centroide> centroides;
+            Atribuicao atribuicao;
+            int iteracoes = executarComBackend(quantizado, instancias, 10, 7, centroides, atribuicao);
+
+            ostringstream cenario;
+            cenario << " (" << bits << " bits, separacao " << separacao << ")";
+            if (iteracoes != iteracoesDenso) {
+                return "iteracoes: " + to_string(iteracoes) + ", esperadas " + to_string(iteracoesDenso) + cenario.str();
+            }
+            string motivo = compararVetores("rotulos" + cenario.str(), atribuicaoDensa.rotulos, atribuicao.rotulos);
+            if (motivo.empty()) motivo = compararVetores("contagens" + cenario.str(), atribuicaoDensa.contagens, atribuicao.contagens);
+            if (motivo.empty()) motivo = compararVetores("somas" + cenario.str(), atribuicaoDensa.somas, atribuicao.somas, 1e-12);
+            if (!motivo.empty()) return motivo;
+        }
+    }
+    return "";
+}
+
+// Warm start com o histórico: os limites de Hamerly só evitam distâncias. O modelo atualizado tem
+// as mesmas iterações, mudanças, massas e centroides de um Lloyd exato sem limites, que atribui
+// histórico e novas instâncias a cada passada a partir dos centroides salvos.
+static string verificarWarmStart() {
+    const int K = 5;
+    const int maxIteracoes = 50;
+    vector<Instancia> historico = gerarBlobs(3000, 8, K, 1.5, 0.0, 11);
+    // Outros centros e o dobro de instâncias: os centroides se deslocam ao longo de várias passadas e
+    // parte do histórico muda de cluster, então limites mal ajustados mudam o resultado
+    vector<Instancia> novas = gerarBlobs(6000, 8, K, 1.5, 0.0, 12);
+
+    DadosNuma dados(historico, TopologiaNuma::detectar());
+    vector<Centroide> centroides = criarCentroidesAleatorios(K, historico, 11);
+    Atribuicao atribuicao;
+    executarLloyd(centroides, historico, dados, atribuicao, 11, VAZIO_ROUBAR_MAIS_DISTANTE);
+    calcularCentroidesProximos(centroides, historico, dados, atribuicao, 0);
+    Modelo modelo(centroides, historico.size(), calcularInercia(centroides));
+
+    // Referência
+    const size_t d = modelo.getDimensao();
+    vector<double> posicoes = modelo.getCentroides();
+    vector<Instancia> todas = historico;
+    todas.insert(todas.end(), novas.begin(), novas.end());
+    vector<vector<double>> linhas;
+    for (const Instancia& instancia : todas) {
+        linhas.push_back(instancia.getAtributos());
+    }
+    auto maisProximo = [&](const vector<double>& linha) {
+        int melhor = 0;
+        double menor = numeric_limits<double>::max();
+        for (int k = 0; k < K; ++k) {
+            double distancia = 0.0;
+            for (size_t j = 0; j < d; ++j) {
+                double diferenca = linha[j] - posicoes[k * d + j];
+                distancia += diferenca * diferenca;
+            }
+            if (distancia < menor) {
+                menor = distancia;
+                melhor = k;
+            }
+        }
+        return melhor;
+    };
+    vector<double> massas(K);
+    auto moverParaAsMedias = [&](const vector<int>& rotulos) {
+        vector<double> somas(K * d, 0.0);
+        fill(massas.begin(), massas.end(), 0.0);
+        for (size_t i = 0; i < rotulos.size(); ++i) {
+            if (rotulos[i] < 0) continue;
+            for (size_t j = 0; j < d; ++j) {
+                somas[rotulos[i] * d + j] += linhas[i][j];
+            }
+            massas[rotulos[i]] += 1.0;
+        }
+        for (int k = 0; k < K; ++k) {
+            if (massas[k] == 0.0) continue;
+            for (size_t j = 0; j < d; ++j) {
+                posicoes[k * d + j] = somas[k * d + j] / massas[k];
+            }
+        }
+    };
+
+    // Passada inicial só do histórico, depois histórico e novas até nenhuma instância mudar
+    vector<int> rotulos(todas.size(), -1);
+    for (size_t i = 0; i < historico.size(); ++i) {
+        rotulos[i] = maisProximo(linhas[i]);
+    }
+    moverParaAsMedias(rotulos);
+    int iteracoes = 0;
+    size_t mudancas = 0;
+    for (int iteracao = 1; iteracao <= maxIteracoes; ++iteracao) {
+        size_t mudancasPassada = 0;
+        for (size_t i = 0; i < todas.size(); ++i) {
+            int rotulo = maisProximo(linhas[i]);
+            if (rotulo == rotulos[i]) continue;
+            if (rotulos[i] >= 0) mudancas++;
+            rotulos[i] = rotulo;
+            mudancasPassada++;
+        }
+        iteracoes = iteracao;
+        if (mudancasPassada == 0) break;
+        moverParaAsMedias(rotulos);
+    }
+
+    Modelo::ResultadoAtualizacao resultado = modelo.atualizar(novas, historico, maxIteracoes);
+    if (resultado.iteracoes != iteracoes || resultado.mudancas != mudancas) {
+        return "iteracoes/mudancas: " + to_string(resultado.iteracoes) + "/" + to_string(resultado.mudancas)
+             + ", esperadas " + to_string(iteracoes) + "/" + to_string(mudancas);
+    }
+    if (mudancas == 0 || resultado.distanciasEvitadas == 0) {
+        return "cenario sem mudancas no historico ou sem distancias evitadas";
+    }
+    if (modelo.getNumInstanciasTreino() != todas.size()) {
+        return "numInstanciasTreino: " + to_string(modelo.getNumInstanciasTreino());
+    }
+    string motivo = compararVetores("massas", massas, modelo.getMassas());
+    if (motivo.empty()) motivo = compararVetores("centroides", posicoes, modelo.getCentroides(), 1e-12);
+    if (motivo.empty()) motivo = compararVetores("rotulos", rotulos, modelo.predizer(todas));
+    return motivo;
+}
+
+// Pontos de controle: um Lloyd interrompido e retomado do último ponto de controle chega às mesmas
+// iterações, rótulos, distâncias e centroides da execução sem interrupção. Um arquivo truncado é
+// recusado e um arquivo inexistente não é retomado.
+static string verificarRetomada() {
+    const int K = 8;
+    const uint64_t semente = 13;
+    vector<Instancia> instancias = gerarBlobs(5000, 12, K, 1.5, 0.5, semente);
+    DadosNuma dados(instancias, TopologiaNuma::detectar());
+
+    vector<Centroide> centroidesCompletos = criarCentroidesAleatorios(K, instancias, semente);
+    Atribuicao completa;
+    int iteracoesCompletas = executarLloyd(centroidesCompletos, instancias, dados, completa, semente, VAZIO_KMEANSPP);
+
+    ConfiguracaoPontoDeControle pontoDeControle;
+    pontoDeControle.caminho = caminhoTemporario("ponto.bin");
+    pontoDeControle.intervalo = 3;
+    pontoDeControle.incluirDistancias = true;
+    CriterioParada interrupcao;
+    interrupcao.maxIteracoes = 7;
+    if (iteracoesCompletas <= interrupcao.maxIteracoes) {
+        return "cenario convergiu em " + to_string(iteracoesCompletas) + " iteracoes, antes da interrupcao";
+    }
+
+    vector<Centroide> centroides = criarCentroidesAleatorios(K, instancias, semente);
+    Atribuicao atribuicao;
+    executarLloyd(centroides, instancias, dados, atribuicao, semente, VAZIO_KMEANSPP, interrupcao, pontoDeControle);
+
+    PontoDeControle salvo;
+    if (!PontoDeControle::carregar(pontoDeControle.caminho, salvo)) return "ponto de controle nao foi gravado";
+    if (salvo.iteracao != 3 && salvo.iteracao != 6) return "ponto de controle da iteracao " + to_string(salvo.iteracao);
+
+    // A retomada parte de centroides quaisquer: o estado salvo substitui as posições
+    vector<Centroide> retomados = criarCentroidesAleatorios(K, instancias, semente + 1);
+    Atribuicao retomada;
+    int iteracoes = executarLloyd(retomados, instancias, dados, retomada, semente, VAZIO_KMEANSPP, CriterioParada(), pontoDeControle, &salvo);
+    if (iteracoes != iteracoesCompletas) {
+        return "iteracoes: " + to_string(iteracoes) + ", esperadas " + to_string(iteracoesCompletas);
+    }
+    string motivo = compararVetores("rotulos", completa.rotulos, retomada.rotulos);
+    if (motivo.empty()) motivo = compararVetores("distancias", completa.distancias, retomada.distancias);
+    if (motivo.empty()) motivo = compararVetores("contagens", completa.contagens, retomada.contagens);
+    if (motivo.empty()) motivo = compararVetores("centroides", posicoesDe(centroidesCompletos), posicoesDe(retomados));
+    if (!motivo.empty()) return motivo;
+
+    filesystem::resize_file(pontoDeControle.caminho, filesystem::file_size(pontoDeControle.caminho) - 4);
+    try {
+        PontoDeControle::carregar(pontoDeControle.caminho, salvo);
+        return "ponto de controle truncado foi aceito";
+    } catch (const runtime_error&) {
+    }
+    filesystem::remove(pontoDeControle.caminho);
+    if (PontoDeControle::carregar(pontoDeControle.caminho, salvo)) return "arquivo inexistente foi carregado";
+    return "";
+}
+
+static string compararEstatisticas(const string& nome, const EstatisticasAtributos& esperadas, const EstatisticasAtributos& obtidas) {
+    if (esperadas.numInstancias != obtidas.numInstancias) {
+        return nome + ": " + to_string(obtidas.numInstancias) + " instancias, esperadas " + to_string(esperadas.numInstancias);
+    }
+    string motivo = compararVetores(nome + ".medias", esperadas.medias, obtidas.medias);
+    if (motivo.empty()) motivo = compararVetores(nome + ".somasQuadrados", esperadas.somasQuadrados, obtidas.somasQuadrados);
+    if (motivo.empty()) motivo = compararVetores(nome + ".menores", esperadas.menores, obtidas.menores);
+    if (motivo.empty()) motivo = compararVetores(nome + ".maiores", esperadas.maiores, obtidas.maiores);
+    return motivo;
+}
+
+// Leitura em pipeline: em arquivos de vários pedaços de leitura, com linhas em branco, espaços
+// repetidos e uma coluna de rótulo ignorada, lerTabela e carregarArquivos devolvem os valores
+// gravados, as mesmas estatísticas de EstatisticasAtributos::calcular sobre as instâncias e o mesmo
+// reservatório de amostrarInstancias.
+static string verificarCarga() {
+    const size_t numInstancias = 100000;
+    const size_t tamanhoAmostra = 16;
+    const uint64_t semente = 17;
+    vector<Instancia> instancias = gerarBlobs(numInstancias, 9, 4, 8.0, 0.0, semente);
+
+    // Seis atributos e o rótulo no primeiro arquivo, os outros três no segundo
+    const string caminhoA = caminhoTemporario("a.txt");
+    const string caminhoB = caminhoTemporario("b.txt");
+    vector<Instancia> primeiros, ultimos;
+    {
+        ofstream arquivoA(caminhoA), arquivoB(caminhoB);
+        arquivoA << setprecision(17);
+        arquivoB << setprecision(17);
+        for (size_t i = 0; i < numInstancias; ++i) {
+            const vector<double> atributos = instancias[i].getAtributos();
+            for (size_t j = 0; j < 6; ++j) {
+                arquivoA << atributos[j] << (j % 2 == 0 ? "  " : " ");
+            }
+            arquivoA << "classe-" << i % 4 << '\n';
+            arquivoB << atributos[6] << ' ' << atributos[7] << ' ' << atributos[8] << '\n';
+            if (i % 1000 == 999) {
+                arquivoA << '\n';
+            }
+            primeiros.emplace_back(i, vector<double>(atributos.begin(), atributos.begin() + 6));
+            ultimos.emplace_back(i, vector<double>(atributos.begin() + 6, atributos.end()));
+        }
+    }
+
+    TabelaNumerica tabela = lerTabela(caminhoA, ' ', 6, tamanhoAmostra, semente);
+    if (tabela.numLinhas != numInstancias || tabela.numColunas != 6) {
+        return "tabela com " + to_string(tabela.numLinhas) + " x " + to_string(tabela.numColunas);
+    }
+    vector<double> esperados;
+    for (const Instancia& instancia : primeiros) {
+        const vector<double> atributos = instancia.getAtributos();
+        esperados.insert(esperados.end(), atributos.begin(), atributos.end());
+    }
+    const vector<size_t> amostra = amostrarInstancias(numInstancias, tamanhoAmostra, semente);
+    string motivo = compararVetores("valores", esperados, tabela.valores);
+    if (motivo.empty()) motivo = compararEstatisticas("tabela", EstatisticasAtributos::calcular(primeiros), tabela.estatisticas);
+    if (motivo.empty()) motivo = compararVetores("amostra da tabela", amostra, tabela.amostra.getIndices());
+    if (!motivo.empty()) return motivo;
+
+    BaseCarregada base = carregarArquivos({caminhoA, caminhoB}, ' ', 6, tamanhoAmostra, semente);
+    if (base.instancias.size() != numInstancias) {
+        return "base com " + to_string(base.instancias.size()) + " instancias";
+    }
+    for (size_t i = 0; i < numInstancias; ++i) {
+        motivo = compararVetores("instancia " + to_string(i), instancias[i].getAtributos(), base.instancias[i].getAtributos());
+        if (!motivo.empty()) return motivo;
+    }
+    EstatisticasAtributos concatenadas = EstatisticasAtributos::calcular(primeiros);
+    concatenadas.concatenar(EstatisticasAtributos::calcular(ultimos));
+    motivo = compararEstatisticas("base", EstatisticasAtributos::calcular(instancias), base.estatisticas);
+    if (motivo.empty()) motivo = compararEstatisticas("base concatenada", concatenadas, base.estatisticas);
+    if (motivo.empty()) motivo = compararVetores("amostra da base", amostra, base.amostra);
+
+    filesystem::remove(caminhoA);
+    filesystem::remove(caminhoB);
+    return motivo;
+}
+
+int main(int argc, char** argv) {
+    const vector<pair<string, function<string()>>> verificacoes = {
+        {"modelo_ida_e_volta", verificarModeloIdaEVolta},
+        {"esparso_denso", verificarEsparsoDenso},
+        {"quantizado_denso", verificarQuantizadoDenso},
+        {"warm_start", verificarWarmStart},
+        {"retomada", verificarRetomada},
+        {"carga", verificarCarga},
+    };
+
+    const set<string> pedidas(argv + 1, argv + argc);
+    set<string> desconhecidas = pedidas;
+    int falhas = 0;
+    for (const auto& [nome, verificar] : verificacoes) {
+        if (!pedidas.empty() && !pedidas.count(nome)) continue;
+        desconhecidas.erase(nome);
+
+        string motivo;
+        try {
+            motivo = verificar();
+        } catch (const exception& erro) {
+            motivo = string("excecao: ") + erro.what();
+        }
+        if (motivo.empty()) {
+            cout << "OK     " << nome << endl;
+        } else {
+            cout << "FALHA  " << nome << ": " << motivo << endl;
+            falhas++;
+        }
+    }
+    for (const string& nome : desconhecidas) {
+        cerr << "Verificacao desconhecida: " << nome << endl;
+        falhas++;
+    }
+
+    return falhas > 0 ? 1 : 0;
+}
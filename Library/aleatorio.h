@@ -0,0 +1,52 @@
+#ifndef K_MEANS_ALEATORIO_H
+#define K_MEANS_ALEATORIO_H
+
+#include <cstdint>
+#include <limits>
+
+using namespace std;
+
+// Famílias de fluxos aleatórios; o fluxo de uma tarefa é a família somada ao índice da tarefa
+enum FluxoAleatorio : uint64_t {
+    FLUXO_CENTROIDES = 1ull << 56,
+    FLUXO_REINICIO = 2ull << 56,
+    FLUXO_CORESET = 3ull << 56,
+    FLUXO_PROJECAO = 4ull << 56,
+    FLUXO_HIERARQUICO = 5ull << 56,
+    FLUXO_VAZIO = 6ull << 56,
+    FLUXO_SINTETICO = 7ull << 56,
+    FLUXO_RESERVATORIO = 8ull << 56,
+    FLUXO_DISTORCAO = 9ull << 56
+};
+
+// Gerador aleatório baseado em contador: o n-ésimo número do fluxo (semente, fluxo) é uma função
+// pura de (semente, fluxo, n), calculada por um misturador SplitMix64. Fluxos distintos são
+// independentes, então cada tarefa gera os seus números sem depender da ordem de execução das
+// outras nem do número de threads.
+class GeradorAleatorio {
+    private:
+        uint64_t chave;
+        uint64_t contador;
+
+    public:
+    using result_type = uint64_t;
+
+    // Construtores
+    GeradorAleatorio(uint64_t semente, uint64_t fluxo);
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return numeric_limits<uint64_t>::max(); }
+    result_type operator()();
+
+    // Número uniforme em [0, 1)
+    double uniforme();
+
+    // Acesso direto ao n-ésimo número de um fluxo
+    static uint64_t gerar(uint64_t semente, uint64_t fluxo, uint64_t contador);
+    static double uniforme(uint64_t semente, uint64_t fluxo, uint64_t contador);
+
+    // Semente nova a partir de random_device, para quando o usuário não fixa uma
+    static uint64_t sementeAleatoria();
+};
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef K_MEANS_ATRIBUICAO_H
+#define K_MEANS_ATRIBUICAO_H
+
+#include "centroide.h"
+#include <vector>
+
+using namespace std;
+
+// Resultado de uma passada de atribuição: rótulo de cada instância e somas/contagens por cluster.
+// As somas são ponderadas pelo peso das instâncias e massas guarda a soma dos pesos de cada cluster.
+// distancias guarda a distância quadrada de cada instância ao centroide atribuído; mudancas e
+// inercia são subprodutos da passada (rótulos alterados e soma ponderada das distâncias).
+// distanciasCalculadas conta as distâncias exatas avaliadas na passada e distanciasEvitadas as
+// que a representação conseguiu descartar sem calcular.
+struct Atribuicao {
+    vector<int> rotulos;
+    vector<double> distancias;
+    vector<double> somas;
+    vector<int> contagens;
+    vector<double> massas;
+    size_t mudancas = 0;
+    double inercia = 0.0;
+    size_t distanciasCalculadas = 0;
+    size_t distanciasEvitadas = 0;
+};
+
+// Representação da base usada na passada de atribuição. Cada implementação (densa por nó NUMA,
+// esparsa CSR, ...) calcula os rótulos e as somas/contagens a partir dos centroides atuais.
+class DadosAtribuicao {
+    public:
+    virtual ~DadosAtribuicao() = default;
+
+    virtual size_t getNumInstancias() const = 0;
+    virtual size_t getDimensao() const = 0;
+    virtual void atribuir(const vector<Centroide>& centroides, Atribuicao& atribuicao) = 0;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef K_MEANS_CARGA_H
+#define K_MEANS_CARGA_H
+
+#include "instancia.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+// Estatísticas por atributo: média e soma dos quadrados dos desvios (Welford), menor e maior valor.
+// São acumuladas por blocos de SomaEmArvore::TAMANHO_BLOCO linhas e os blocos combinados em ordem,
+// então o resultado é o mesmo calculado durante a leitura ou sobre as instâncias já carregadas.
+struct EstatisticasAtributos {
+    size_t numInstancias = 0;
+    vector<double> medias;
+    vector<double> somasQuadrados;
+    vector<double> menores;
+    vector<double> maiores;
+
+    void iniciar(size_t dimensao);
+    void acumular(const double* linha);
+    // Mesmos atributos, outras linhas (Chan et al.)
+    void combinar(const EstatisticasAtributos& outra);
+    // Mesmas linhas, outros atributos (arquivos com colunas diferentes da mesma base)
+    void concatenar(const EstatisticasAtributos& outra);
+
+    size_t getDimensao() const;
+    // Desvio padrão populacional do atributo j
+    double getDesvioPadrao(size_t j) const;
+
+    static EstatisticasAtributos calcular(const vector<Instancia>& instancias);
+};
+
+// Amostra uniforme sem reposição por reservatório: cada linha i recebe uma chave que depende apenas
+// de (semente, i) e ficam as capacidade menores chaves. A amostra não depende da ordem em que as
+// linhas chegam, então reservatórios de blocos lidos em paralelo podem ser combinados.
+class Reservatorio {
+    private:
+        size_t capacidade;
+        uint64_t semente;
+        // Heap de máximo pela chave
+        vector<pair<double, size_t>> itens;
+
+    public:
+    // Construtores
+    Reservatorio(size_t capacidade = 0, uint64_t semente = 0);
+
+    void oferecer(size_t indice);
+    void combinar(const Reservatorio& outro);
+    // Índices amostrados, em ordem crescente de chave
+    vector<size_t> getIndices() const;
+};
+
+// Tabela numérica lida de um arquivo texto, linha a linha (linhas em branco são ignoradas)
+struct TabelaNumerica {
+    size_t numLinhas = 0;
+    size_t numColunas = 0;
+    vector<double> valores;
+    EstatisticasAtributos estatisticas;
+    Reservatorio amostra;
+};
+
+// Base carregada em pipeline: instâncias, estatísticas dos atributos e amostra do reservatório
+struct BaseCarregada {
+    vector<Instancia> instancias;
+    EstatisticasAtributos estatisticas;
+    vector<size_t> amostra;
+};
+
+// Leitura em pipeline: uma thread lê o arquivo em pedaços grandes e, a cada grupo completo de blocos
+// de linhas, dispara a conversão desse trecho em paralelo com a leitura do restante. Cada trecho
+// converte os números com from_chars e já devolve as estatísticas dos seus blocos e o seu
+// reservatório. separador ' ' aceita qualquer sequência de espaços; maxColunas > 0 ignora os campos
+// além dos primeiros (o rótulo da Iris, por exemplo).
+TabelaNumerica lerTabela(const string& caminho, char separador = ' ', size_t maxColunas = 0, size_t tamanhoAmostra = 0, uint64_t semente = 0);
+
+// Arquivos com as mesmas linhas e atributos diferentes, lidos ao mesmo tempo e concatenados por linha
+BaseCarregada carregarArquivos(const vector<string>& caminhos, char separador = ' ', size_t maxColunas = 0, size_t tamanhoAmostra = 0, uint64_t semente = 0);
+
+BaseCarregada carregarIris(size_t tamanhoAmostra = 0, uint64_t semente = 0);
+BaseCarregada carregarMFeat(size_t tamanhoAmostra = 0, uint64_t semente = 0);
+
+#endif
@@ -2,6 +2,8 @@
 #define K_MEANS_CENTROIDE_H
 
 #include "instancia.h"
+#include "aleatorio.h"
+#include "carga.h"
 #include <vector>
 #include <chrono>
 
@@ -19,22 +21,26 @@ class Centroide{
     // Getters
     int getId() const;
     vector<double> getAtributos() const;
-    vector<Instancia> getProximos() const;
+    const vector<Instancia>& getProximos() const;
 
     // Setters
     void setId(int id);
     void setAtributos(const vector<double>& atributos);
+    void setAtributos(const double* atributos, size_t dimensao);
     void setProximos(const vector<Instancia>& proximos);
     void limparInstanciasProximas();
     void adicionarInstancia(const Instancia& instancia);
 
     // Função para criar centroide aleatorio
     static Centroide criarCentroideAleatorio(int id, vector<Instancia> instancias);
+    static Centroide criarCentroideAleatorio(int id, const vector<Instancia>& instancias, GeradorAleatorio& gerador);
+    // Sorteio a partir de estatísticas já calculadas (por exemplo, durante a leitura), sem percorrer a base
+    static Centroide criarCentroideAleatorio(int id, const EstatisticasAtributos& estatisticas, GeradorAleatorio& gerador);
 
     //Função para escrever arquivo com os centroides
     static void escreverCentroide(const vector<Centroide>& centroides, const string& nome_arquivo);
     static void escreverCentroidesComInstancias(const vector<Centroide>& centroides, const string& nome_arquivo);
-    static void escreverCentroidesComInstancias(const vector<Centroide>& centroides, const vector<chrono::milliseconds>& durations, const vector<double>& indices);
+    static void escreverCentroidesComInstancias(const vector<Centroide>& centroides, const vector<chrono::milliseconds>& durations, const vector<double>& indices, const vector<string>& observacoes = {});
 
 
     bool operator==(const Centroide& other) const {
@@ -0,0 +1,73 @@
+#ifndef K_MEANS_CONTADORES_H
+#define K_MEANS_CONTADORES_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdint>
+
+using namespace std;
+
+// Valores dos contadores de hardware; um contador que não pôde ser aberto fica em 0 e com
+// disponivel[i] falso
+struct LeituraContadores {
+    enum Evento {
+        CICLOS,
+        INSTRUCOES,
+        FALTAS_LLC,
+        ERROS_DESVIO,
+        OPERACOES_VETORIAIS,
+        NUM_EVENTOS
+    };
+
+    uint64_t valores[NUM_EVENTOS] = {};
+    bool disponivel[NUM_EVENTOS] = {};
+
+    LeituraContadores operator-(const LeituraContadores& outra) const;
+    LeituraContadores& operator+=(const LeituraContadores& outra);
+};
+
+// Perfil por fase com contadores de hardware (perf_event_open, apenas Linux). Os contadores são
+// do processo com herança, então cobrem as threads de trabalho criadas dentro de cada fase.
+// Enquanto um objeto existe ele é o perfil ativo e o Lloyd mede nele as fases de atribuição e
+// atualização; sem permissão ou sem suporte (fora do Linux, perf_event_paranoid, máquinas
+// virtuais) os eventos ausentes são apenas omitidos do relatório.
+class PerfilHardware {
+    private:
+        struct Fase {
+            LeituraContadores total;
+            double micros = 0.0;
+            size_t medicoes = 0;
+        };
+
+        int descritores[LeituraContadores::NUM_EVENTOS];
+        map<string, Fase> fases;
+        vector<string> fasesEmOrdem;
+        string motivoIndisponivel;
+        LeituraContadores marca;
+        double instanteMarca;
+
+        static PerfilHardware* atual;
+
+    public:
+    // Construtores
+    PerfilHardware();
+    ~PerfilHardware();
+    PerfilHardware(const PerfilHardware&) = delete;
+    PerfilHardware& operator=(const PerfilHardware&) = delete;
+
+    static PerfilHardware* getAtual();
+
+    // Verdadeiro se ao menos ciclos ou instruções puderam ser abertos
+    bool estaDisponivel() const;
+    LeituraContadores ler() const;
+    // Início de uma fase: guarda a leitura atual e o instante
+    void marcar();
+    // Acumula na fase os eventos e o tempo desde a última marca, e marca de novo
+    void registrar(const string& fase);
+
+    // Uma linha por fase com IPC, faltas na LLC, banda estimada (faltas x 64 bytes) e erros de desvio
+    vector<string> relatorio() const;
+};
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef K_MEANS_CORESET_H
+#define K_MEANS_CORESET_H
+
+#include "instancia.h"
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Coreset leve por amostragem de sensibilidade (importância) em duas passadas:
+// 1) média, soma dos quadrados e massa total da base;
+// 2) cada instância entra com probabilidade p = min(1, m * q), onde
+//    q = 1/(2W) * w + w * d(x, média)^2 / (2 * soma das distâncias), e recebe peso w / p.
+// O custo ponderado de qualquer conjunto de K centroides no coreset aproxima o custo na base
+// inteira com erro (1 ± e) mais um termo aditivo controlado pelo tamanho m.
+// As instâncias retornadas mantêm o id original e carregam o peso calculado. Com a mesma semente,
+// o coreset é o mesmo para qualquer número de threads.
+vector<Instancia> construirCoreset(const vector<Instancia>& instancias, size_t tamanho);
+vector<Instancia> construirCoreset(const vector<Instancia>& instancias, size_t tamanho, uint64_t semente);
+
+#endif
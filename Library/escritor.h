@@ -0,0 +1,114 @@
+#ifndef K_MEANS_ESCRITOR_H
+#define K_MEANS_ESCRITOR_H
+
+#include "centroide.h"
+#include <vector>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <thread>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+using namespace std;
+
+// Escrita com buffer grande e uma thread de escrita em segundo plano: quem produz formata no buffer
+// (números com to_chars, sem iostream) e, quando ele enche, o entrega à thread, que faz a E/S
+// enquanto o chamador segue calculando. No máximo maxPendentes buffers ficam na fila; acima disso
+// o produtor espera. Uma falha de escrita (disco cheio, erro de E/S) é guardada pela thread e
+// informada por fechar().
+class EscritorAssincrono {
+    private:
+        string caminho;
+        ofstream arquivo;
+        string buffer;
+        size_t tamanhoBuffer;
+        size_t maxPendentes;
+        deque<string> fila;
+        mutex mtx;
+        condition_variable sinal;
+        bool encerrar;
+        bool aberto;
+        // Escrito só pela thread de escrita; lido depois do join
+        bool falhou;
+        bool gravado;
+        thread trabalhador;
+
+        void entregar();
+        void executar();
+
+    public:
+    // Construtores
+    EscritorAssincrono(const string& caminho, bool binario = false, size_t tamanhoBuffer = 1 << 20, size_t maxPendentes = 4);
+    ~EscritorAssincrono();
+    EscritorAssincrono(const EscritorAssincrono&) = delete;
+    EscritorAssincrono& operator=(const EscritorAssincrono&) = delete;
+
+    bool estaAberto() const;
+
+    void escrever(const char* dados, size_t tamanho);
+    void escreverTexto(string_view texto);
+    void escreverCaractere(char caractere);
+    void escreverInteiro(int64_t valor);
+    // Menor representação decimal que relê o mesmo double
+    void escreverReal(double valor);
+    // Notação fixa com o número de casas dado
+    void escreverReal(double valor, int casas);
+
+    template <typename T>
+    void escreverBinario(const T& valor) {
+        escrever(reinterpret_cast<const char*>(&valor), sizeof(T));
+    }
+    template <typename T>
+    void escreverBinario(const vector<T>& valores) {
+        escrever(reinterpret_cast<const char*>(valores.data()), valores.size() * sizeof(T));
+    }
+
+    // Entrega o buffer restante e espera a thread terminar a escrita. Falso (com a mensagem em
+    // cerr) se o arquivo não abriu ou se algum trecho não pôde ser gravado
+    bool fechar();
+};
+
+// Resultados de uma execução em binário e CSV, com o mesmo prefixo:
+//   <prefixo>.bin             "KMRS", versão, K, d, n, centroides (K x d), pares (id, cluster) em
+//                             int32, número de índices e os seus valores
+//   <prefixo>.centroides.csv  cluster,a0,a1,...
+//   <prefixo>.rotulos.csv     id,cluster
+//   <prefixo>.indices.csv     indice,valor
+// A partição é gravada logo que fica pronta e os índices depois: quem chama só copia os números
+// da partição, e a formatação e a E/S dos rótulos correm numa thread própria junto com o cálculo
+// das métricas.
+class EscritorResultados {
+    private:
+        EscritorAssincrono binario;
+        EscritorAssincrono centroidesCsv;
+        EscritorAssincrono rotulosCsv;
+        EscritorAssincrono indicesCsv;
+        // Declarado depois dos escritores para ser destruído (e aguardado) antes deles
+        future<void> particao;
+
+        void iniciarParticao(const vector<Centroide>& centroides, vector<pair<int32_t, int32_t>> rotulos);
+        void aguardarParticao();
+
+    public:
+    static constexpr char MAGICO[4] = {'K', 'M', 'R', 'S'};
+    static constexpr uint32_t VERSAO = 1;
+
+    // Construtores
+    EscritorResultados(const string& prefixo);
+    ~EscritorResultados();
+
+    bool estaAberto() const;
+
+    void escreverParticao(const vector<Centroide>& centroides);
+    // Partição dada pelos rótulos de cada linha, para bases sem as instâncias próximas nos centroides
+    void escreverParticao(const vector<Centroide>& centroides, const vector<int>& ids, const vector<int>& rotulos);
+    void escreverIndices(const vector<string>& nomes, const vector<double>& valores);
+    // Falso se algum dos arquivos não pôde ser gravado por completo
+    bool fechar();
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef K_MEANS_ESPARSO_H
+#define K_MEANS_ESPARSO_H
+
+#include "atribuicao.h"
+#include <vector>
+#include <string>
+
+using namespace std;
+
+// Base de dados esparsa no formato CSR: as entradas não nulas da linha i estão em
+// [inicioLinhas[i], inicioLinhas[i + 1]) de colunas/valores. A distância ao centroide é
+// calculada como ||x||^2 - 2 x.c + ||c||^2, com as normas em cache, de modo que o custo
+// por par instância/centroide seja proporcional ao número de não nulos e não a d.
+class DadosEsparsos : public DadosAtribuicao {
+    private:
+        size_t dimensao;
+        vector<size_t> inicioLinhas;
+        vector<int> colunas;
+        vector<double> valores;
+        vector<double> normasLinhas;
+        vector<double> pesos;
+        vector<int> ids;
+
+    public:
+    // Construtores
+    DadosEsparsos(size_t dimensao = 0);
+
+    // Getters
+    size_t getNumInstancias() const override;
+    size_t getDimensao() const override;
+    size_t getNumNaoNulos() const;
+    const vector<int>& getIds() const;
+    // Linha i com os zeros preenchidos
+    vector<double> getLinhaDensa(size_t i) const;
+
+    // Adiciona uma linha a partir dos pares (coluna, valor); valores nulos são descartados
+    void adicionarLinha(int id, const vector<pair<int, double>>& entradas, double peso = 1.0);
+
+    // Leitura em fluxo de um arquivo SVMlight ("rotulo indice:valor ...", índices a partir de 1): cada
+    // linha vai direto para os vetores CSR, sem passar pela forma densa, então a memória acompanha o
+    // número de não nulos. O rótulo e campos qid: são ignorados e o id de cada linha é a sua ordem.
+    static DadosEsparsos lerSvmLight(const string& caminho);
+    // Conversão a partir da base densa
+    static DadosEsparsos deInstancias(const vector<Instancia>& instancias);
+
+    void atribuir(const vector<Centroide>& centroides, Atribuicao& atribuicao) override;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef K_MEANS_HIERARQUICO_H
+#define K_MEANS_HIERARQUICO_H
+
+#include "centroide.h"
+#include <vector>
+
+using namespace std;
+
+// Árvore de k-means hierárquico. Cada divisão roda o Lloyd apenas sobre as instâncias do
+// cluster de maior SSE, criando "ramificacao" filhos, até existirem K folhas. As folhas são
+// os centroides finais e a árvore funciona como índice: uma nova instância desce da raiz
+// escolhendo o filho mais próximo, em O(ramificacao * profundidade) distâncias.
+class ArvoreKmeans {
+    public:
+    struct No {
+        vector<double> atributos;
+        vector<int> filhos;
+        vector<int> indices;
+        double sse;
+        int folha;
+    };
+
+    private:
+        vector<No> nos;
+        vector<int> folhas;
+
+    public:
+    // Construtores
+    ArvoreKmeans() = default;
+
+    // Getters
+    const vector<No>& getNos() const;
+    int getNumFolhas() const;
+
+    // Centroides das folhas, com id igual à posição da folha
+    vector<Centroide> getCentroides() const;
+
+    static ArvoreKmeans construir(vector<Instancia>& instancias, int K, int ramificacao = 2);
+    static ArvoreKmeans construir(vector<Instancia>& instancias, int K, int ramificacao, uint64_t semente);
+
+    // Retorna a folha mais próxima descendo a árvore a partir da raiz
+    int atribuir(const vector<double>& atributos) const;
+
+    // Preenche as instâncias próximas de cada centroide usando a árvore como índice
+    void atribuirInstancias(vector<Centroide>& centroides, const vector<Instancia>& instancias) const;
+};
+
+#endif
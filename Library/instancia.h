@@ -10,19 +10,22 @@ class Instancia {
     private:
         int id;
         vector<double> atributos;
+        double peso;
 
     public:
 
     // Construtores
-    Instancia(int id, vector<double> atributos);
+    Instancia(int id, vector<double> atributos, double peso = 1.0);
 
     // Getters
     int getId() const;
     vector<double> getAtributos() const;
+    double getPeso() const;
 
     // Setters
     void setId(int id);
     void setAtributos(const vector<double>& atributos);
+    void setPeso(double peso);
 
     // Manipulação de Atributos
     void adicionarAtributo(double atributo);
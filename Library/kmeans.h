@@ -2,20 +2,122 @@
 #define KMEANS_H
 
 #include "centroide.h"
+#include "numa.h"
+#include "vazios.h"
+#include "rastreamento.h"
+#include "pontocontrole.h"
+#include <memory>
 #include <vector>
 #include <map>
+#include <string>
+
+// Regras de parada do Lloyd; a execução termina quando qualquer regra ativa é satisfeita
+struct CriterioParada {
+    // Maior deslocamento de uma coordenada de centroide entre duas iterações (regra original)
+    double toleranciaDeslocamento = 0.001;
+    // Fração das instâncias que mudaram de cluster na última passada (0 desativa)
+    double fracaoMudancas = 0.0;
+    // Melhora relativa da inércia entre duas passadas (0 desativa)
+    double melhoraInercia = 0.0;
+    // Número máximo de iterações (0 = sem limite)
+    int maxIteracoes = 0;
+};
+
+// Opções de execução do kmeans; os valores padrão reproduzem o algoritmo original
+struct ConfiguracaoKmeans {
+    // Número esperado de pontos do coreset (0 desativa e clusteriza a base inteira)
+    size_t tamanhoCoreset = 0;
+    // Com coreset, refaz uma atribuição exata sobre a base completa ao final
+    bool atribuicaoFinalCompleta = true;
+    // Divide recursivamente o cluster de maior SSE em vez de rodar o Lloyd plano com K centroides
+    bool hierarquico = false;
+    // Número de filhos por divisão no modo hierárquico (2 = bisecting k-means)
+    int ramificacao = 2;
+    // Se definido, salva o modelo treinado neste arquivo binário (ver Modelo); com redução de
+    // dimensionalidade, exige a atribuição final no espaço original
+    string caminhoModelo;
+    // Warm start a partir de um modelo salvo: as instâncias além das getNumInstanciasTreino()
+    // primeiras são tratadas como novas e o treino parte dos centroides do modelo
+    string caminhoModeloAnterior;
+    // No warm start, também deixa as instâncias do histórico mudarem de cluster (uma passada
+    // completa inicial, depois limites de Hamerly)
+    bool reatribuirHistorico = false;
+    int iteracoesIncrementais = 5;
+    // No warm start, atribui e avalia a base inteira no relatório em vez de só as novas instâncias
+    bool avaliacaoCompletaWarmStart = false;
+    // Converte a base para CSR e usa o kernel de distância esparso (bases com muitos zeros)
+    bool esparso = false;
+    // Se definido, clusteriza este arquivo SVMlight em vez da base pedida: a leitura monta o CSR
+    // direto (ver DadosEsparsos::lerSvmLight) e as instâncias densas nunca são criadas. Os centroides
+    // partem de linhas amostradas, clusters vazios mantêm a posição e as métricas que dependem das
+    // instâncias densas não são calculadas
+    string caminhoBaseEsparsa;
+    // Threads do backend denso (0 = uma por CPU)
+    size_t threadsAtribuicao = 0;
+    // Atribuição com a base quantizada em 8 ou 16 bits por atributo (0 desativa); os rótulos são
+    // os mesmos da precisão completa
+    int bitsQuantizacao = 0;
+    // Dimensão do espaço reduzido em que o Lloyd roda (0 desativa a redução)
+    size_t dimensaoReduzida = 0;
+    // PCA por SVD aleatorizado em vez da projeção aleatória de Johnson-Lindenstrauss
+    bool reducaoPca = false;
+    // Com redução, faz a atribuição final no espaço original
+    bool atribuicaoFinalOriginal = true;
+    // Escolhe o backend do Lloyd (denso e número de threads, esparso ou quantizado) pelo formato da
+    // base, calibrando numa amostra as faixas que ainda não estão no perfil da máquina; vale apenas
+    // quando nenhum backend é pedido explicitamente (ver SeletorBackend)
+    bool selecaoAutomatica = false;
+    string caminhoPerfilMaquina = "perfil_backends.txt";
+    bool calibrarSelecao = true;
+    // Semente de todos os sorteios da execução (0 sorteia uma nova, informada no relatório)
+    uint64_t semente = 0;
+    // Centroides iniciais nas instâncias do reservatório amostrado durante a leitura (Forgy) em vez
+    // de sorteados dentro da faixa de cada atributo
+    bool inicializacaoAmostra = false;
+    // Tratamento de clusters vazios no laço de Lloyd; as políticas de reparo local são aplicadas
+    // em todas as passadas, o reinício aleatório apenas na primeira
+    PoliticaVazio politicaVazio = VAZIO_REINICIAR;
+    CriterioParada parada;
+    // Pontos de controle periódicos do Lloyd plano e retomada a partir do último
+    ConfiguracaoPontoDeControle pontoDeControle;
+    // Se definido, grava neste arquivo o rastreamento de cada iteração do Lloyd e das fases da execução
+    string caminhoRastreamento;
+    Rastreamento::Formato formatoRastreamento = Rastreamento::JSON_LINHAS;
+    // Mede ciclos, instruções, faltas na LLC e erros de desvio por fase (atribuição, atualização,
+    // métricas) com os contadores de hardware do Linux e registra IPC e banda no relatório
+    bool contadoresHardware = false;
+    // Se definido, grava rótulos, centroides e índices em <prefixo>.bin e em CSV (ver EscritorResultados),
+    // com a E/S em segundo plano durante o cálculo das métricas
+    string prefixoResultados;
+};
 
 vector<Centroide> criarCentroidesAleatorios(int numeroK, vector<Instancia>& instancias);
+vector<Centroide> criarCentroidesAleatorios(int numeroK, vector<Instancia>& instancias, uint64_t semente);
+vector<Centroide> criarCentroidesAleatorios(int numeroK, const EstatisticasAtributos& estatisticas, uint64_t semente);
+// Índices de uma amostra uniforme sem reposição, a mesma que o reservatório da leitura escolhe
+vector<size_t> amostrarInstancias(size_t numInstancias, size_t tamanho, uint64_t semente);
+// Inicialização de Forgy: cada centroide parte de uma instância amostrada
+vector<Centroide> criarCentroidesDaAmostra(const vector<Instancia>& instancias, const vector<size_t>& amostra);
 double calcularDistanciaEuclidiana(vector<double> vetorInstancia, vector<double> vetorCentroide);
 void calcularCentroidesProximos(vector<Centroide>& centroides, const vector<Instancia>& instancias, int estado);
+void calcularCentroidesProximos(vector<Centroide>& centroides, const vector<Instancia>& instancias, DadosAtribuicao& dados, Atribuicao& atribuicao, int estado, uint64_t semente = 0, PoliticaVazio politica = VAZIO_REINICIAR);
 Centroide calcularCentroideMaisProximo(vector<Centroide>& centroides, const Instancia& instancia);
 void atualizarCentroides(vector<Centroide>& centroides);
+void atualizarCentroides(vector<Centroide>& centroides, const Atribuicao& atribuicao);
+int executarLloyd(vector<Centroide>& centroides, vector<Instancia>& instancias, DadosAtribuicao& dados, Atribuicao& atribuicao);
+// Com retomada, o estado carregado substitui a passada inicial e as iterações já feitas (e é consumido)
+int executarLloyd(vector<Centroide>& centroides, vector<Instancia>& instancias, DadosAtribuicao& dados, Atribuicao& atribuicao, uint64_t semente, PoliticaVazio politica = VAZIO_REINICIAR, const CriterioParada& parada = CriterioParada(), const ConfiguracaoPontoDeControle& pontoDeControle = ConfiguracaoPontoDeControle(), PontoDeControle* retomada = nullptr);
 bool verificarConvergencia(const vector<Centroide>& centroides, const vector<Centroide>& centroidesAntigos, double tolerancia);
+unique_ptr<DadosAtribuicao> criarDadosAtribuicao(const vector<Instancia>& instancias, const ConfiguracaoKmeans& configuracao);
+void elevarCentroides(vector<Centroide>& centroides, const vector<Instancia>& originais);
 void kmeans(int baseDeDados,int K);
+void kmeans(int baseDeDados, int K, const ConfiguracaoKmeans& configuracao);
 map<int, int> mapearMatrizEsperada(const vector<Centroide>& centroides, int baseDados);
 map<int,int> mapearMatrizReal(const vector<Centroide>& centroides, int baseDados);
 void imprimirMap(const map<int, int>& mapa);
 double fmeasure(vector<Centroide>& centroides, int baseDados,const vector<Instancia>& instancias);
+double silhouetteMeasure(const vector<Centroide>& centroides);
+double calcularInercia(const vector<Centroide>& centroides);
 double daviesBouldin(const vector<Centroide>& centroides);
 double distanciaIntraClusterDaviesBouldin(Centroide centroide);
 double calinskiHarabasz(vector<Centroide> centroides, vector<Instancia> instancias);
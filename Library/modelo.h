@@ -0,0 +1,82 @@
+#ifndef K_MEANS_MODELO_H
+#define K_MEANS_MODELO_H
+
+#include "centroide.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+using namespace std;
+
+// Modelo treinado: centroides contíguos (K x d), normas quadradas e metadados do treino.
+// O arquivo binário tem o cabeçalho "KMDL", versão, tipo dos dados, K, d, metadados,
+// seguido dos centroides (no tipo indicado) e das normas em double. A partir da versão 2 vêm
+// também as estatísticas suficientes de cada cluster (somas ponderadas, massas, contagens e
+// somas de ||x||^2), que permitem atualizar o modelo com novas instâncias sem rever o histórico.
+class Modelo {
+    public:
+    enum TipoDados : uint32_t {
+        FLOAT64 = 1,
+        FLOAT32 = 2
+    };
+
+    struct ResultadoAtualizacao {
+        int iteracoes;
+        // Instâncias (novas ou do histórico) que mudaram de cluster desde a primeira atribuição
+        size_t mudancas;
+        // Cálculos de distância evitados pelos limites no histórico
+        size_t distanciasEvitadas;
+    };
+
+    private:
+        size_t numCentroides;
+        size_t dimensao;
+        vector<double> centroides;
+        vector<double> normas;
+        uint64_t numInstanciasTreino;
+        double inercia;
+        int64_t dataTreino;
+        vector<double> somas;
+        vector<double> massas;
+        vector<uint64_t> contagens;
+        vector<double> somasQuadrados;
+
+        void recalcularCentroides();
+
+    public:
+    // Construtores
+    Modelo() = default;
+    // As estatísticas dos clusters vêm das instâncias próximas de cada centroide
+    Modelo(const vector<Centroide>& centroides, uint64_t numInstanciasTreino, double inercia);
+
+    // Getters
+    size_t getNumCentroides() const;
+    size_t getDimensao() const;
+    const vector<double>& getCentroides() const;
+    const vector<double>& getNormas() const;
+    uint64_t getNumInstanciasTreino() const;
+    double getInercia() const;
+    int64_t getDataTreino() const;
+    vector<Centroide> getCentroidesComoObjetos() const;
+    // Falso para modelos da versão 1 ou sem instâncias atribuídas
+    bool temEstatisticas() const;
+    const vector<double>& getMassas() const;
+
+    // Persistência
+    // Falso se o arquivo não pôde ser gravado por completo
+    bool salvar(const string& caminho, TipoDados tipo = FLOAT64) const;
+    static Modelo carregar(const string& caminho);
+
+    // Atribui cada ponto (linhas contíguas de tamanho d) ao centroide mais próximo, usando todas as CPUs
+    vector<int> predizer(const double* pontos, size_t numPontos) const;
+    vector<int> predizer(const vector<Instancia>& instancias) const;
+
+    // Warm start: atribui apenas as novas instâncias e roda até maxIteracoes passadas do Lloyd
+    // partindo dos centroides atuais, com o histórico representado pelas estatísticas guardadas;
+    // o custo é proporcional ao número de novas instâncias. Se o histórico for passado, as suas
+    // instâncias também podem mudar de cluster, com limites de Hamerly evitando a maior parte das
+    // distâncias depois da primeira passada.
+    ResultadoAtualizacao atualizar(const vector<Instancia>& novas, const vector<Instancia>& historico = {}, int maxIteracoes = 5);
+};
+
+#endif
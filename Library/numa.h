@@ -0,0 +1,69 @@
+#ifndef K_MEANS_NUMA_H
+#define K_MEANS_NUMA_H
+
+#include "atribuicao.h"
+#include <vector>
+#include <string>
+
+using namespace std;
+
+// Nós NUMA da máquina e as CPUs de cada um
+class TopologiaNuma {
+    private:
+        vector<vector<int>> cpusPorNo;
+
+    public:
+    // Construtores
+    TopologiaNuma() = default;
+    TopologiaNuma(vector<vector<int>> cpusPorNo);
+
+    // Getters
+    int getNumNos() const;
+    int getNumCpus() const;
+    const vector<int>& getCpus(int no) const;
+
+    // Lê /sys/devices/system/node; sem NUMA, retorna um único nó com todas as CPUs
+    static TopologiaNuma detectar();
+
+    // Restringe a thread atual às CPUs do nó. Retorna false se não for possível.
+    bool fixarThreadNoNo(int no) const;
+};
+
+// Base de dados contígua particionada entre os nós NUMA. Cada partição é um intervalo
+// [inicio, fim) das instâncias, copiado por uma thread fixada no nó dono, de modo que a
+// política de first-touch aloque as páginas na memória local desse nó.
+class DadosNuma : public DadosAtribuicao {
+    public:
+    struct Particao {
+        int no;
+        size_t inicio;
+        size_t fim;
+        vector<double> linhas;
+        vector<double> pesos;
+    };
+
+    private:
+        TopologiaNuma topologia;
+        size_t numInstancias;
+        size_t dimensao;
+        vector<Particao> particoes;
+        vector<vector<double>> replicas;
+
+    public:
+    // Construtores
+    DadosNuma(const vector<Instancia>& instancias, const TopologiaNuma& topologia, size_t numThreads = 0);
+
+    // Getters
+    const TopologiaNuma& getTopologia() const;
+    size_t getNumInstancias() const override;
+    size_t getDimensao() const override;
+    const vector<Particao>& getParticoes() const;
+    const vector<double>& getReplica(int no) const;
+
+    // Copia os centroides para a réplica de cada nó, usando uma thread do próprio nó
+    void replicarCentroides(const vector<Centroide>& centroides);
+
+    void atribuir(const vector<Centroide>& centroides, Atribuicao& atribuicao) override;
+};
+
+#endif
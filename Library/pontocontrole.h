@@ -0,0 +1,69 @@
+#ifndef K_MEANS_PONTOCONTROLE_H
+#define K_MEANS_PONTOCONTROLE_H
+
+#include <vector>
+#include <string>
+#include <future>
+#include <cstdint>
+
+using namespace std;
+
+// Pontos de controle do laço de Lloyd
+struct ConfiguracaoPontoDeControle {
+    // Arquivo do ponto de controle (vazio desativa)
+    string caminho;
+    // Iterações entre dois pontos de controle
+    int intervalo = 10;
+    // Também guarda a distância de cada instância ao seu centroide
+    bool incluirDistancias = false;
+    // Se o arquivo existir, o Lloyd continua dele em vez de começar do zero; o kmeans carrega o
+    // arquivo uma vez e entrega o estado ao executarLloyd
+    bool retomar = false;
+};
+
+// Estado do Lloyd ao fim de uma iteração. Os sorteios de cada passada derivam de (semente,
+// iteração), então a semente e o número da iteração bastam como estado do gerador; com as posições
+// e os rótulos, a continuação refaz exatamente as mesmas passadas da execução sem interrupção.
+struct PontoDeControle {
+    uint64_t semente = 0;
+    int32_t iteracao = 0;
+    uint64_t numCentroides = 0;
+    uint64_t dimensao = 0;
+    uint64_t numInstancias = 0;
+    double inerciaAnterior = -1.0;
+    vector<double> posicoes;
+    vector<double> somas;
+    vector<double> massas;
+    vector<int32_t> contagens;
+    vector<int32_t> rotulos;
+    // Vazio quando não incluídas
+    vector<double> distancias;
+
+    // Grava em caminho.tmp, sincroniza com o disco e renomeia: o arquivo anterior só é substituído
+    // por um ponto de controle completo
+    void salvar(const string& caminho) const;
+    // Falso se o arquivo não existe; lança runtime_error se ele existe mas é inválido ou se o
+    // cabeçalho não corresponde ao tamanho do arquivo
+    static bool carregar(const string& caminho, PontoDeControle& estado);
+};
+
+// Gravação em segundo plano: o laço entrega uma cópia do estado e segue. Se a gravação anterior
+// ainda não terminou, o novo ponto de controle é descartado em vez de bloquear a iteração.
+class GravadorPontoDeControle {
+    private:
+        string caminho;
+        future<void> pendente;
+        size_t descartados;
+
+    public:
+    // Construtores
+    GravadorPontoDeControle(const string& caminho);
+    ~GravadorPontoDeControle();
+
+    // Falso se o estado foi descartado
+    bool gravar(PontoDeControle estado);
+    size_t getDescartados() const;
+    void aguardar();
+};
+
+#endif
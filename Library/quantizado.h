@@ -0,0 +1,51 @@
+#ifndef K_MEANS_QUANTIZADO_H
+#define K_MEANS_QUANTIZADO_H
+
+#include "atribuicao.h"
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Base quantizada por atributo em int8 ou int16 para a passada de atribuição: x = media + S q + e,
+// com S a diagonal das escalas e e o resíduo. Com g = c - media, a distância é estimada como
+// ||x - media||^2 - 2 q.(S g) + ||g||^2, onde q.(S g) vem de um produto interno inteiro com o
+// centroide quantizado a cada passada. Por Cauchy-Schwarz o erro de cada estimativa é limitado por
+// 2 (||q|| ||S g - t r|| + ||e|| ||g||); só as instâncias cuja margem entre o melhor centroide e os
+// demais não supera esses limites são reverificadas com as distâncias exatas, então os rótulos são
+// os mesmos da precisão completa. As somas dos clusters usam os dados originais.
+class DadosQuantizados : public DadosAtribuicao {
+    private:
+        int bits;
+        size_t numInstancias;
+        size_t dimensao;
+        vector<double> linhas;
+        vector<double> pesos;
+        vector<double> media;
+        vector<double> escalas;
+        vector<int8_t> codigos8;
+        vector<int16_t> codigos16;
+        // Por instância: ||x - media||^2, ||q|| e ||e||
+        vector<double> normasDesvio;
+        vector<double> normasCodigo;
+        vector<double> normasResiduo;
+        size_t reverificadas;
+
+        template <typename T>
+        void atribuirQuantizado(const vector<T>& codigos, const vector<Centroide>& centroides, Atribuicao& atribuicao);
+
+    public:
+    // Construtores
+    DadosQuantizados(const vector<Instancia>& instancias, int bits = 8);
+
+    // Getters
+    size_t getNumInstancias() const override;
+    size_t getDimensao() const override;
+    int getBits() const;
+    // Instâncias reverificadas com distâncias exatas na última passada
+    size_t getReverificadas() const;
+
+    void atribuir(const vector<Centroide>& centroides, Atribuicao& atribuicao) override;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef K_MEANS_RASTREAMENTO_H
+#define K_MEANS_RASTREAMENTO_H
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Medições de uma iteração do Lloyd (tempos em microssegundos)
+struct IteracaoLloyd {
+    int chamada = 0;
+    int iteracao = 0;
+    double inicio = 0.0;
+    double tempoAtribuicao = 0.0;
+    double tempoReparo = 0.0;
+    double tempoAtualizacao = 0.0;
+    double tempoConvergencia = 0.0;
+    double inercia = 0.0;
+    size_t mudancas = 0;
+    size_t distanciasCalculadas = 0;
+    size_t distanciasEvitadas = 0;
+    int64_t bytesAlocados = 0;
+};
+
+// Rastreamento do caminho crítico. Enquanto um objeto existe ele é o rastreamento ativo, e o
+// Lloyd registra cada iteração nele; os eventos ficam em memória e são gravados no destrutor,
+// como JSON por linha ou no formato de trace do Chrome (chrome://tracing, Perfetto).
+// Sem rastreamento ativo o custo é um teste de ponteiro por iteração; compilando com
+// -DKMEANS_SEM_RASTREAMENTO, a classe inteira vira um esboço vazio em linha (nenhum evento, nenhum
+// arquivo, agora() constante) e o código de medição é eliminado pelo compilador.
+#ifdef KMEANS_SEM_RASTREAMENTO
+class Rastreamento {
+    public:
+    enum Formato {
+        JSON_LINHAS,
+        TRACE_CHROME
+    };
+
+    // Construtores
+    Rastreamento(const string&, Formato = JSON_LINHAS) {}
+    Rastreamento(const Rastreamento&) = delete;
+    Rastreamento& operator=(const Rastreamento&) = delete;
+
+    static bool ativo() { return false; }
+    static Rastreamento* getAtual() { return nullptr; }
+    static double agora() { return 0.0; }
+    static int64_t bytesAlocados() { return 0; }
+    static bool contaAlocacoes() { return false; }
+
+    int novaChamada() { return 0; }
+    void registrarIteracao(const IteracaoLloyd&) {}
+    void registrarFase(const string&, double, double) {}
+};
+#else
+class Rastreamento {
+    public:
+    enum Formato {
+        JSON_LINHAS,
+        TRACE_CHROME
+    };
+
+    private:
+        string caminho;
+        Formato formato;
+        mutex mtx;
+        vector<string> eventos;
+        int chamadas;
+
+        static Rastreamento* atual;
+
+    public:
+    // Construtores
+    Rastreamento(const string& caminho, Formato formato = JSON_LINHAS);
+    ~Rastreamento();
+    Rastreamento(const Rastreamento&) = delete;
+    Rastreamento& operator=(const Rastreamento&) = delete;
+
+    static bool ativo() {
+        return atual != nullptr;
+    }
+    static Rastreamento* getAtual();
+
+    // Relógio monotônico em microssegundos
+    static double agora();
+    // Bytes alocados por operator new enquanto há rastreamento ativo. A contagem substitui o operator
+    // new global, então só existe compilando com -DKMEANS_CONTAR_ALOCACOES; sem ela o valor é 0 e
+    // bytes_alocados sai como null
+    static int64_t bytesAlocados();
+    static bool contaAlocacoes();
+
+    // Identificador de uma execução do Lloyd, para separar as iterações de chamadas diferentes
+    int novaChamada();
+    void registrarIteracao(const IteracaoLloyd& iteracao);
+    // Fase de alto nível da execução (leitura, treino, avaliação...)
+    void registrarFase(const string& nome, double inicio, double duracao);
+};
+#endif
+
+#endif
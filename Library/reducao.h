@@ -0,0 +1,51 @@
+#ifndef K_MEANS_REDUCAO_H
+#define K_MEANS_REDUCAO_H
+
+#include "instancia.h"
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// Projeção linear para um espaço de dimensão menor: y = C (x - media), com C de tamanho
+// dimReduzida x dimOriginal. Pode ser uma projeção aleatória de Johnson-Lindenstrauss ou as
+// componentes principais obtidas por SVD aleatorizado.
+class Projecao {
+    public:
+    // Desvio relativo |r - 1| das distâncias entre pares, com r = ||P(x - y)|| / ||x - y||
+    struct Distorcao {
+        double media;
+        double maxima;
+    };
+
+    private:
+        size_t dimOriginal;
+        size_t dimReduzida;
+        vector<double> media;
+        vector<double> componentes;
+        double varianciaRetida;
+
+    public:
+    // Construtores
+    Projecao() = default;
+
+    // Getters
+    size_t getDimOriginal() const;
+    size_t getDimReduzida() const;
+    const vector<double>& getComponentes() const;
+    // Fração da variância preservada (apenas PCA; -1 na projeção aleatória)
+    double getVarianciaRetida() const;
+
+    // Projeção esparsa de Achlioptas: entradas sqrt(3/k) * {+1, 0, -1} com probabilidades {1/6, 2/3, 1/6}
+    static Projecao aleatoria(size_t dimOriginal, size_t dimReduzida, uint64_t semente);
+    // PCA por SVD aleatorizado (Halko et al.) com sobreamostragem e iterações de potência
+    static Projecao pca(const vector<Instancia>& instancias, size_t dimReduzida, uint64_t semente, int iteracoesPotencia = 2);
+
+    vector<double> projetar(const vector<double>& atributos) const;
+    vector<Instancia> aplicar(const vector<Instancia>& instancias) const;
+
+    // Desvio relativo das distâncias em numPares pares sorteados do fluxo FLUXO_DISTORCAO da semente
+    Distorcao medirDistorcao(const vector<Instancia>& originais, const vector<Instancia>& projetadas, uint64_t semente, size_t numPares = 1000) const;
+};
+
+#endif
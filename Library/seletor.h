@@ -0,0 +1,81 @@
+#ifndef K_MEANS_SELETOR_H
+#define K_MEANS_SELETOR_H
+
+#include "kmeans.h"
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdint>
+
+using namespace std;
+
+enum BackendAtribuicao {
+    BACKEND_DENSO,
+    BACKEND_ESPARSO,
+    BACKEND_QUANTIZADO8,
+    BACKEND_QUANTIZADO16
+};
+
+// Formato da tarefa. Tarefas na mesma faixa (potência de 2 de n, d e K, décimo da densidade)
+// compartilham a decisão guardada no perfil da máquina.
+struct FormatoTarefa {
+    size_t numInstancias = 0;
+    size_t dimensao = 0;
+    size_t numCentroides = 0;
+    // Fração de atributos não nulos, medida numa amostra
+    double densidade = 1.0;
+    size_t numCpus = 1;
+
+    static FormatoTarefa medir(const vector<Instancia>& instancias, size_t K, uint64_t semente);
+    string getFaixa() const;
+};
+
+struct EscolhaBackend {
+    BackendAtribuicao backend = BACKEND_DENSO;
+    // Threads do backend denso (0 = todas)
+    size_t numThreads = 0;
+    // Tempo estimado de uma passada sobre a amostra de calibração (0 se não calibrado)
+    double microsPorPassada = 0.0;
+    string motivo;
+
+    // Traduz a escolha para as opções de backend da configuração
+    void aplicar(ConfiguracaoKmeans& configuracao) const;
+    string descrever() const;
+    static string nome(BackendAtribuicao backend);
+};
+
+// Escolhe o backend de atribuição do Lloyd plano: consulta o perfil da máquina e, se a faixa da
+// tarefa ainda não foi vista, calibra os candidatos numa amostra da base (ou, sem calibração,
+// aplica regras fixas sobre densidade, dimensão e tamanho). O perfil é um arquivo texto com uma
+// decisão por linha, identificada pela máquina e pela faixa; uma decisão com mais threads do que as
+// CPUs atuais é ignorada. Os backends denso e quantizado dão os mesmos rótulos; o esparso pode
+// decidir de outro modo centroides quase equidistantes, o que é indicado na descrição da escolha.
+class SeletorBackend {
+    private:
+        string caminhoPerfil;
+        bool calibrar;
+        string maquina;
+        map<string, EscolhaBackend> decisoes;
+
+        void lerPerfil();
+        void gravarPerfil() const;
+        EscolhaBackend calibrarAmostra(const vector<Instancia>& instancias, const FormatoTarefa& formato, uint64_t semente) const;
+        static EscolhaBackend aplicarRegras(const FormatoTarefa& formato);
+
+    public:
+    // Instâncias da amostra de calibração e passadas medidas por candidato
+    static const size_t TAMANHO_CALIBRACAO = 8192;
+    static const int PASSADAS_CALIBRACAO = 3;
+    // Iterações em que o custo de montar o backend é amortizado na comparação
+    static const int ITERACOES_AMORTIZACAO = 20;
+
+    // Construtores
+    SeletorBackend(const string& caminhoPerfil = "", bool calibrar = true);
+
+    EscolhaBackend escolher(const vector<Instancia>& instancias, size_t K, uint64_t semente);
+
+    // Nome do host e número de CPUs
+    static string identificarMaquina();
+};
+
+#endif
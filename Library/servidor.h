@@ -0,0 +1,98 @@
+#ifndef K_MEANS_SERVIDOR_H
+#define K_MEANS_SERVIDOR_H
+
+#include "modelo.h"
+#include <vector>
+#include <string>
+#include <deque>
+#include <set>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+
+using namespace std;
+
+// Servidor de atribuição de baixa latência sobre socket Unix (ou TCP em localhost).
+//
+// Protocolo (inteiros little-endian):
+//   pedido:   uint32 numPontos, uint32 dimensao, numPontos * dimensao doubles
+//   resposta: uint32 numPontos, numPontos int32 com o rótulo de cada ponto
+//             (numPontos = 0xFFFFFFFF indica dimensão incompatível com o modelo; os pontos do pedido
+//             são descartados e a conexão continua)
+//             (numPontos = 0xFFFFFFFE indica pedido acima de MAX_PONTOS_POR_PEDIDO pontos ou
+//             MAX_VALORES_POR_PEDIDO valores; a conexão é encerrada)
+//   Um pedido com numPontos = 0 e dimensao = 0 retorna as estatísticas:
+//             uint64 numPedidos, double p50 e double p99 da latência em microssegundos
+//
+// Pedidos concorrentes são agrupados em um único lote para o kernel de atribuição e o modelo
+// é trocado atomicamente quando o arquivo em disco é modificado.
+class ServidorAtribuicao {
+    private:
+        struct Pedido {
+            vector<double> pontos;
+            size_t numPontos;
+            size_t dimensao;
+            promise<vector<int>> resultado;
+        };
+
+        string caminhoModelo;
+        string caminhoSocket;
+        int porta;
+        int descritorEscuta;
+
+        shared_ptr<const Modelo> modelo;
+        atomic<bool> executando;
+
+        mutex mutexFila;
+        condition_variable condicaoFila;
+        deque<shared_ptr<Pedido>> fila;
+
+        mutex mutexMonitor;
+        condition_variable condicaoMonitor;
+
+        // Cada cliente fecha o seu descritor ao terminar e entra em clientesEncerrados; as threads
+        // encerradas são unidas a cada nova conexão e no desligamento
+        mutex mutexClientes;
+        set<int> descritoresClientes;
+        map<uint64_t, thread> threadsClientes;
+        vector<uint64_t> clientesEncerrados;
+        uint64_t proximoCliente;
+
+        mutex mutexLatencias;
+        vector<double> latencias;
+        size_t proximaLatencia;
+        uint64_t numPedidos;
+
+        void processarLotes();
+        void monitorarModelo();
+        void atenderCliente(uint64_t id, int descritor);
+        void atenderPedidos(int descritor);
+        void unirClientesEncerrados();
+        void fecharEscuta();
+        void registrarLatencia(double microssegundos);
+
+    public:
+    // Limites de um pedido, conferidos antes de alocar os pontos
+    static const uint32_t MAX_PONTOS_POR_PEDIDO = 1 << 20;
+    static const uint64_t MAX_VALORES_POR_PEDIDO = 1 << 24;
+
+    // Construtores: com caminhoSocket vazio, escuta em 127.0.0.1:porta
+    ServidorAtribuicao(const string& caminhoModelo, const string& caminhoSocket, int porta = 0);
+    ~ServidorAtribuicao();
+
+    // Bloqueia aceitando conexões até parar() ser chamado
+    void executar();
+    void parar();
+
+    // Percentil (0 a 100) da latência dos últimos pedidos, em microssegundos
+    double getLatenciaPercentil(double percentil);
+    uint64_t getNumPedidos();
+};
+
+#endif
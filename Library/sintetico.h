@@ -0,0 +1,53 @@
+#ifndef K_MEANS_SINTETICO_H
+#define K_MEANS_SINTETICO_H
+
+#include "instancia.h"
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+using namespace std;
+
+// Parâmetros da base sintética de blobs gaussianos
+struct ParametrosBlobs {
+    size_t numInstancias = 10000;
+    size_t dimensao = 16;
+    int numClusters = 8;
+    // Desvio padrão das coordenadas dos centros, em unidades do desvio padrão de cada blob
+    double separacao = 8.0;
+    // Expoente de Zipf do tamanho dos clusters: o cluster k recebe peso (k + 1)^-desequilibrio
+    // (0 gera clusters de mesmo tamanho esperado)
+    double desequilibrio = 0.0;
+    uint64_t semente = 1;
+};
+
+// Gerador de blobs gaussianos isotrópicos. A instância i é uma função pura de (semente, i): o
+// cluster e os atributos vêm do seu próprio fluxo aleatório, então a base é a mesma com qualquer
+// número de threads e pode ser gerada em blocos, em paralelo, sem materializá-la inteira.
+class GeradorBlobs {
+    private:
+        ParametrosBlobs parametros;
+        vector<double> centros;
+        vector<double> pesosAcumulados;
+
+        Instancia gerarInstancia(size_t i) const;
+
+    public:
+    // Construtores
+    GeradorBlobs(const ParametrosBlobs& parametros);
+
+    // Getters
+    const ParametrosBlobs& getParametros() const;
+    // Centros dos clusters, K x d
+    const vector<double>& getCentros() const;
+
+    // Cluster verdadeiro da instância i
+    int clusterDe(size_t i) const;
+
+    // Entrega a base ao consumidor em blocos consecutivos (início, instâncias), na ordem; cada lote
+    // de blocos é gerado em paralelo, então a memória usada é a de um bloco por thread
+    void gerar(const function<void(size_t, vector<Instancia>&)>& consumidor, size_t tamanhoBloco = 65536) const;
+    vector<Instancia> gerarTodas() const;
+};
+
+#endif
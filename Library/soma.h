@@ -0,0 +1,50 @@
+#ifndef K_MEANS_SOMA_H
+#define K_MEANS_SOMA_H
+
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+// Redução determinística de vetores parciais calculados por bloco de instâncias. A base é dividida
+// em blocos de TAMANHO_BLOCO linhas e as parciais são somadas numa árvore binária fixa sobre os
+// índices dos blocos: no nível h, o nó j é a soma dos nós 2j e 2j + 1 do nível h - 1 (ou cópia do
+// nó 2j quando o irmão cai além do último bloco). Assim a ordem das somas em ponto flutuante, e
+// portanto o resultado bit a bit, não depende de quantas threads processaram os blocos.
+class SomaEmArvore {
+    public:
+    static const size_t TAMANHO_BLOCO = 256;
+
+    // Parcial de um nó: densa ou, se esparsa, só as posições de indices (em ordem crescente) com os
+    // respectivos valores. Posições ausentes valem zero, então a soma com um nó esparso dá o mesmo
+    // resultado da soma densa, com custo proporcional às entradas presentes.
+    struct No {
+        size_t nivel;
+        size_t indice;
+        vector<double> valores;
+        bool esparso;
+        vector<size_t> indices;
+    };
+
+    // Acumula os blocos consecutivos de uma thread, combinando na hora os irmãos completos
+    class Pilha {
+        private:
+            size_t numBlocos;
+            vector<No> nos;
+
+            void subir();
+
+        public:
+        Pilha(size_t numBlocos);
+        void adicionar(size_t bloco, vector<double> valores);
+        void adicionarEsparso(size_t bloco, vector<size_t> indices, vector<double> valores);
+        vector<No>& getNos();
+    };
+
+    static size_t numBlocos(size_t numInstancias);
+
+    // Combina os nós de todas as threads na ordem fixa da árvore
+    static vector<double> combinar(vector<No> nos, size_t numBlocos, size_t tamanho);
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef K_MEANS_VAZIOS_H
+#define K_MEANS_VAZIOS_H
+
+#include "atribuicao.h"
+#include "instancia.h"
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// O que fazer com um centroide que ficou sem instâncias após uma passada de atribuição
+enum PoliticaVazio {
+    // Sorteia um centroide aleatório novo e refaz a passada inteira (comportamento original)
+    VAZIO_REINICIAR,
+    // Move para o cluster vazio a instância mais distante do seu centroide
+    VAZIO_ROUBAR_MAIS_DISTANTE,
+    // Divide o cluster de maior SSE: o membro mais distante vira o novo centroide e leva
+    // consigo os membros que ficam mais próximos dele
+    VAZIO_DIVIDIR_MAIOR_SSE,
+    // Sorteia a instância com probabilidade proporcional a peso * distância², como no k-means++
+    VAZIO_KMEANSPP
+};
+
+// Reparo local dos clusters vazios: rótulos, distâncias, somas, contagens e massas são corrigidos
+// apenas para as instâncias movidas, e cada centroide reparado passa a ser a média dos membros
+// que recebeu. A escolha do doador é uma varredura O(n) sobre as distâncias já calculadas; a correção
+// custa O(tamanho do cluster * d), sem uma nova passada O(n * K * d).
+// Retorna o número de clusters reparados. VAZIO_REINICIAR não é tratada aqui.
+int repararClustersVazios(vector<Centroide>& centroides, const vector<Instancia>& instancias, Atribuicao& atribuicao,
+                          PoliticaVazio politica, uint64_t semente, uint64_t rodada);
+
+#endif
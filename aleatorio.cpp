@@ -0,0 +1,38 @@
+#include "Library/aleatorio.h"
+#include <random>
+
+using namespace std;
+
+static inline uint64_t misturar(uint64_t z) {
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Construtores
+GeradorAleatorio::GeradorAleatorio(uint64_t semente, uint64_t fluxo)
+    : chave(misturar(semente ^ misturar(fluxo))), contador(0) {}
+
+GeradorAleatorio::result_type GeradorAleatorio::operator()() {
+    return misturar(chave + misturar(contador++));
+}
+
+double GeradorAleatorio::uniforme() {
+    return ((*this)() >> 11) * 0x1.0p-53;
+}
+
+uint64_t GeradorAleatorio::gerar(uint64_t semente, uint64_t fluxo, uint64_t contador) {
+    GeradorAleatorio gerador(semente, fluxo);
+    gerador.contador = contador;
+    return gerador();
+}
+
+double GeradorAleatorio::uniforme(uint64_t semente, uint64_t fluxo, uint64_t contador) {
+    return (gerar(semente, fluxo, contador) >> 11) * 0x1.0p-53;
+}
+
+uint64_t GeradorAleatorio::sementeAleatoria() {
+    random_device rd;
+    return (uint64_t(rd()) << 32) | rd();
+}
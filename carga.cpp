@@ -0,0 +1,390 @@
+#include "Library/carga.h"
+#include "Library/aleatorio.h"
+#include "Library/soma.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <future>
+#include <thread>
+#include <deque>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+static const size_t LINHAS_POR_BLOCO = SomaEmArvore::TAMANHO_BLOCO;
+static const size_t TAMANHO_LEITURA = 4 << 20;
+
+void EstatisticasAtributos::iniciar(size_t dimensao) {
+    numInstancias = 0;
+    medias.assign(dimensao, 0.0);
+    somasQuadrados.assign(dimensao, 0.0);
+    menores.assign(dimensao, numeric_limits<double>::infinity());
+    maiores.assign(dimensao, -numeric_limits<double>::infinity());
+}
+
+void EstatisticasAtributos::acumular(const double* linha) {
+    numInstancias++;
+    const double n = static_cast<double>(numInstancias);
+    for (size_t j = 0; j < medias.size(); ++j) {
+        double valor = linha[j];
+        double delta = valor - medias[j];
+        medias[j] += delta / n;
+        somasQuadrados[j] += delta * (valor - medias[j]);
+        menores[j] = min(menores[j], valor);
+        maiores[j] = max(maiores[j], valor);
+    }
+}
+
+void EstatisticasAtributos::combinar(const EstatisticasAtributos& outra) {
+    if (outra.numInstancias == 0) return;
+    if (numInstancias == 0) {
+        *this = outra;
+        return;
+    }
+
+    const double na = static_cast<double>(numInstancias);
+    const double nb = static_cast<double>(outra.numInstancias);
+    const double n = na + nb;
+    for (size_t j = 0; j < medias.size(); ++j) {
+        double delta = outra.medias[j] - medias[j];
+        medias[j] += delta * nb / n;
+        somasQuadrados[j] += outra.somasQuadrados[j] + delta * delta * na * nb / n;
+        menores[j] = min(menores[j], outra.menores[j]);
+        maiores[j] = max(maiores[j], outra.maiores[j]);
+    }
+    numInstancias += outra.numInstancias;
+}
+
+void EstatisticasAtributos::concatenar(const EstatisticasAtributos& outra) {
+    if (getDimensao() == 0) {
+        *this = outra;
+        return;
+    }
+    medias.insert(medias.end(), outra.medias.begin(), outra.medias.end());
+    somasQuadrados.insert(somasQuadrados.end(), outra.somasQuadrados.begin(), outra.somasQuadrados.end());
+    menores.insert(menores.end(), outra.menores.begin(), outra.menores.end());
+    maiores.insert(maiores.end(), outra.maiores.begin(), outra.maiores.end());
+}
+
+size_t EstatisticasAtributos::getDimensao() const {
+    return medias.size();
+}
+
+double EstatisticasAtributos::getDesvioPadrao(size_t j) const {
+    return numInstancias > 0 ? sqrt(somasQuadrados[j] / numInstancias) : 0.0;
+}
+
+EstatisticasAtributos EstatisticasAtributos::calcular(const vector<Instancia>& instancias) {
+    EstatisticasAtributos estatisticas;
+    if (instancias.empty()) return estatisticas;
+
+    const size_t d = instancias[0].getAtributos().size();
+    const size_t numBlocos = (instancias.size() + LINHAS_POR_BLOCO - 1) / LINHAS_POR_BLOCO;
+    const size_t numTarefas = min<size_t>(numBlocos, max(1u, thread::hardware_concurrency()));
+    vector<EstatisticasAtributos> blocos(numBlocos);
+
+    vector<future<void>> futures;
+    for (size_t t = 0; t < numTarefas; ++t) {
+        futures.push_back(async(launch::async, [&, t]() {
+            for (size_t b = t; b < numBlocos; b += numTarefas) {
+                blocos[b].iniciar(d);
+                size_t fim = min(instancias.size(), (b + 1) * LINHAS_POR_BLOCO);
+                for (size_t i = b * LINHAS_POR_BLOCO; i < fim; ++i) {
+                    blocos[b].acumular(instancias[i].getAtributos().data());
+                }
+            }
+        }));
+    }
+    for (auto& fut : futures) {
+        fut.get();
+    }
+
+    // Mesma ordem de combinação da leitura, bloco a bloco
+    estatisticas.iniciar(d);
+    for (const EstatisticasAtributos& bloco : blocos) {
+        estatisticas.combinar(bloco);
+    }
+    return estatisticas;
+}
+
+// Construtores
+Reservatorio::Reservatorio(size_t capacidade, uint64_t semente) : capacidade(capacidade), semente(semente) {}
+
+void Reservatorio::oferecer(size_t indice) {
+    if (capacidade == 0) return;
+    pair<double, size_t> item(GeradorAleatorio::uniforme(semente, FLUXO_RESERVATORIO, indice), indice);
+
+    if (itens.size() < capacidade) {
+        itens.push_back(item);
+        push_heap(itens.begin(), itens.end());
+    } else if (item < itens.front()) {
+        pop_heap(itens.begin(), itens.end());
+        itens.back() = item;
+        push_heap(itens.begin(), itens.end());
+    }
+}
+
+void Reservatorio::combinar(const Reservatorio& outro) {
+    for (const pair<double, size_t>& item : outro.itens) {
+        if (itens.size() < capacidade) {
+            itens.push_back(item);
+            push_heap(itens.begin(), itens.end());
+        } else if (capacidade > 0 && item < itens.front()) {
+            pop_heap(itens.begin(), itens.end());
+            itens.back() = item;
+            push_heap(itens.begin(), itens.end());
+        }
+    }
+}
+
+vector<size_t> Reservatorio::getIndices() const {
+    vector<pair<double, size_t>> ordenados = itens;
+    sort(ordenados.begin(), ordenados.end());
+
+    vector<size_t> indices;
+    for (const pair<double, size_t>& item : ordenados) {
+        indices.push_back(item.second);
+    }
+    return indices;
+}
+
+// Trecho do arquivo convertido por uma tarefa: começa sempre num múltiplo de LINHAS_POR_BLOCO,
+// então os seus blocos são os mesmos de EstatisticasAtributos::calcular
+struct TrechoConvertido {
+    vector<double> valores;
+    size_t numLinhas = 0;
+    size_t numColunas = 0;
+    vector<EstatisticasAtributos> blocos;
+    Reservatorio amostra;
+    string erro;
+};
+
+static bool espaco(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static bool linhaEmBranco(const char* inicio, const char* fim) {
+    return all_of(inicio, fim, espaco);
+}
+
+// Converte os campos de uma linha; falso se algum campo não é numérico
+static bool converterLinha(const char* inicio, const char* fim, char separador, size_t maxColunas, vector<double>& valores) {
+    const char* p = inicio;
+    size_t colunas = 0;
+
+    while (maxColunas == 0 || colunas < maxColunas) {
+        while (p < fim && espaco(*p)) ++p;
+        if (p == fim) break;
+        if (*p == '+') ++p;
+
+        double valor;
+        from_chars_result resultado = from_chars(p, fim, valor);
+        if (resultado.ec != errc()) {
+            return false;
+        }
+        valores.push_back(valor);
+        colunas++;
+        p = resultado.ptr;
+
+        while (p < fim && espaco(*p)) ++p;
+        if (separador != ' ' && p < fim) {
+            if (*p != separador) return false;
+            ++p;
+        }
+    }
+    return true;
+}
+
+static TrechoConvertido converterTrecho(const string& texto, size_t primeiraLinha, char separador, size_t maxColunas, size_t tamanhoAmostra, uint64_t semente) {
+    TrechoConvertido trecho;
+    trecho.amostra = Reservatorio(tamanhoAmostra, semente);
+
+    const char* p = texto.data();
+    const char* fimTexto = p + texto.size();
+    while (p < fimTexto) {
+        const char* fimLinha = find(p, fimTexto, '\n');
+        if (!linhaEmBranco(p, fimLinha)) {
+            size_t antes = trecho.valores.size();
+            if (!converterLinha(p, fimLinha, separador, maxColunas, trecho.valores)) {
+                trecho.erro = "valor nao numerico na linha " + to_string(primeiraLinha + trecho.numLinhas + 1);
+                return trecho;
+            }
+
+            size_t colunas = trecho.valores.size() - antes;
+            if (trecho.numLinhas == 0) {
+                trecho.numColunas = colunas;
+            } else if (colunas != trecho.numColunas) {
+                trecho.erro = "numero de colunas diferente na linha " + to_string(primeiraLinha + trecho.numLinhas + 1);
+                return trecho;
+            }
+
+            if (trecho.numLinhas % LINHAS_POR_BLOCO == 0) {
+                trecho.blocos.emplace_back();
+                trecho.blocos.back().iniciar(colunas);
+            }
+            trecho.blocos.back().acumular(trecho.valores.data() + antes);
+            trecho.amostra.oferecer(primeiraLinha + trecho.numLinhas);
+            trecho.numLinhas++;
+        }
+        p = fimLinha < fimTexto ? fimLinha + 1 : fimTexto;
+    }
+    return trecho;
+}
+
+TabelaNumerica lerTabela(const string& caminho, char separador, size_t maxColunas, size_t tamanhoAmostra, uint64_t semente) {
+    TabelaNumerica tabela;
+    tabela.amostra = Reservatorio(tamanhoAmostra, semente);
+
+    ifstream arquivo(caminho, ios::binary);
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir o arquivo: " << caminho << endl;
+        return tabela;
+    }
+
+    // Conversões em andamento, consumidas em ordem; a janela limita a memória de texto pendente
+    const size_t janela = max(2u, thread::hardware_concurrency());
+    deque<future<TrechoConvertido>> pendentes;
+    string erro;
+
+    auto consumir = [&]() {
+        TrechoConvertido trecho = pendentes.front().get();
+        pendentes.pop_front();
+        if (!erro.empty()) return;
+        if (!trecho.erro.empty()) {
+            erro = trecho.erro;
+            return;
+        }
+        if (trecho.numLinhas == 0) return;
+
+        if (tabela.numLinhas == 0) {
+            tabela.numColunas = trecho.numColunas;
+            tabela.estatisticas.iniciar(trecho.numColunas);
+        } else if (trecho.numColunas != tabela.numColunas) {
+            erro = "numero de colunas diferente a partir da linha " + to_string(tabela.numLinhas + 1);
+            return;
+        }
+        tabela.valores.insert(tabela.valores.end(), trecho.valores.begin(), trecho.valores.end());
+        tabela.numLinhas += trecho.numLinhas;
+        for (const EstatisticasAtributos& bloco : trecho.blocos) {
+            tabela.estatisticas.combinar(bloco);
+        }
+        tabela.amostra.combinar(trecho.amostra);
+    };
+
+    auto disparar = [&](string texto, size_t primeiraLinha) {
+        if (pendentes.size() >= janela) {
+            consumir();
+        }
+        pendentes.push_back(async(launch::async, [=, texto = move(texto)]() {
+            return converterTrecho(texto, primeiraLinha, separador, maxColunas, tamanhoAmostra, semente);
+        }));
+    };
+
+    // Texto lido e ainda não entregue; as linhas até "varrido" já foram contadas e "corte" marca o
+    // fim do último grupo completo de blocos
+    string texto;
+    vector<char> pedaco(TAMANHO_LEITURA);
+    size_t varrido = 0, linhas = 0, corte = 0, linhasNoCorte = 0, proximaLinha = 0;
+
+    while (true) {
+        arquivo.read(pedaco.data(), pedaco.size());
+        size_t lidos = arquivo.gcount();
+        texto.append(pedaco.data(), lidos);
+
+        size_t fimLinha;
+        while ((fimLinha = texto.find('\n', varrido)) != string::npos) {
+            if (!linhaEmBranco(texto.data() + varrido, texto.data() + fimLinha) && ++linhas % LINHAS_POR_BLOCO == 0) {
+                corte = fimLinha + 1;
+                linhasNoCorte = linhas;
+            }
+            varrido = fimLinha + 1;
+        }
+
+        if (lidos < pedaco.size()) {
+            if (!texto.empty()) {
+                disparar(move(texto), proximaLinha);
+            }
+            break;
+        }
+
+        if (linhasNoCorte > 0) {
+            disparar(texto.substr(0, corte), proximaLinha);
+            texto.erase(0, corte);
+            proximaLinha += linhasNoCorte;
+            varrido -= corte;
+            linhas -= linhasNoCorte;
+            corte = 0;
+            linhasNoCorte = 0;
+        }
+    }
+
+    while (!pendentes.empty()) {
+        consumir();
+    }
+
+    if (!erro.empty()) {
+        cerr << "Erro ao ler o arquivo " << caminho << ": " << erro << endl;
+        TabelaNumerica vazia;
+        return vazia;
+    }
+    return tabela;
+}
+
+BaseCarregada carregarArquivos(const vector<string>& caminhos, char separador, size_t maxColunas, size_t tamanhoAmostra, uint64_t semente) {
+    BaseCarregada base;
+    if (caminhos.empty()) return base;
+
+    // Os arquivos são lidos ao mesmo tempo; como as chaves do reservatório só dependem do índice
+    // da linha, basta amostrar um deles
+    vector<future<TabelaNumerica>> leituras;
+    for (size_t a = 0; a < caminhos.size(); ++a) {
+        leituras.push_back(async(launch::async, lerTabela, caminhos[a], separador, maxColunas,
+                                 a == 0 ? tamanhoAmostra : 0, semente));
+    }
+    vector<TabelaNumerica> tabelas;
+    for (auto& leitura : leituras) {
+        tabelas.push_back(leitura.get());
+    }
+
+    // Verifica se todos os arquivos têm o mesmo número de linhas
+    const size_t numInstancias = tabelas[0].numLinhas;
+    size_t dimensao = 0;
+    for (const TabelaNumerica& tabela : tabelas) {
+        if (tabela.numLinhas != numInstancias) {
+            cerr << "Erro: os arquivos não possuem o mesmo número de linhas." << endl;
+            return base;
+        }
+        dimensao += tabela.numColunas;
+    }
+
+    // Combina os atributos de cada linha de todos os arquivos em uma única instância
+    base.instancias.reserve(numInstancias);
+    for (size_t i = 0; i < numInstancias; ++i) {
+        vector<double> atributos;
+        atributos.reserve(dimensao);
+        for (const TabelaNumerica& tabela : tabelas) {
+            const double* linha = tabela.valores.data() + i * tabela.numColunas;
+            atributos.insert(atributos.end(), linha, linha + tabela.numColunas);
+        }
+        base.instancias.emplace_back(i, move(atributos));
+    }
+
+    for (const TabelaNumerica& tabela : tabelas) {
+        base.estatisticas.concatenar(tabela.estatisticas);
+    }
+    base.amostra = tabelas[0].amostra.getIndices();
+    return base;
+}
+
+BaseCarregada carregarIris(size_t tamanhoAmostra, uint64_t semente) {
+    // Os quatro primeiros campos são numéricos; o último é o rótulo da classe
+    return carregarArquivos({"Iris/iris.data"}, ',', 4, tamanhoAmostra, semente);
+}
+
+BaseCarregada carregarMFeat(size_t tamanhoAmostra, uint64_t semente) {
+    return carregarArquivos({"Mfeat/mfeat-fou", "Mfeat/mfeat-fac", "Mfeat/mfeat-kar",
+                             "Mfeat/mfeat-pix", "Mfeat/mfeat-zer", "Mfeat/mfeat-mor"},
+                            ' ', 0, tamanhoAmostra, semente);
+}
@@ -1,6 +1,8 @@
 #include "Library/centroide.h"
+#include "Library/escritor.h"
 #include <vector>
 #include <random>
+#include <cmath>
 #include <fstream>
 #include <chrono>
 #include <algorithm>
@@ -22,7 +24,7 @@ vector<double> Centroide::getAtributos() const {
     return atributos;
 }
 
-vector<Instancia> Centroide::getProximos() const {
+const vector<Instancia>& Centroide::getProximos() const {
     return instancias_proximas;
 }
 
@@ -35,52 +37,38 @@ void Centroide::setAtributos(const vector<double>& atributos) {
     this->atributos = atributos;
 }
 
+void Centroide::setAtributos(const double* atributos, size_t dimensao) {
+    this->atributos.assign(atributos, atributos + dimensao);
+}
+
 void Centroide::setProximos(const vector<Instancia>& proximos) {
     this->instancias_proximas = proximos;
 }
 
 Centroide Centroide::criarCentroideAleatorio(int id, vector<Instancia> instancias){
-    int numAtributos = instancias[0].getAtributos().size();
-    double menor;
-    double maior;
-    vector<double> atributos;
-
-    for(int i = 0; i < numAtributos; i++){
-        double soma = 0.0;
-        double variancia = 0.0;
-        vector<double> atributosAvaliados;
-
-        for(int j = 0; j < instancias.size(); j++){
-            double temp = instancias[j].getAtributos()[i];
-            if(j == 0){
-                menor = temp;
-                maior = temp;
-            }
-            soma += temp;
-            atributosAvaliados.push_back(move(temp));
-            if(menor > temp){
-                menor = temp;
-            } else if (maior < temp){
-                maior = temp;
-            }
-        }
+    GeradorAleatorio gerador(GeradorAleatorio::sementeAleatoria(), FLUXO_CENTROIDES + id);
+    return criarCentroideAleatorio(id, instancias, gerador);
+}
 
-        soma = soma/instancias.size();
-        for(double num : atributosAvaliados){
-            variancia += (num - soma) * (num - soma);
-        }
-        variancia = variancia / atributosAvaliados.size();
+Centroide Centroide::criarCentroideAleatorio(int id, const vector<Instancia>& instancias, GeradorAleatorio& gerador){
+    return criarCentroideAleatorio(id, EstatisticasAtributos::calcular(instancias), gerador);
+}
 
-        double desvioPadrao = sqrt(variancia);
+Centroide Centroide::criarCentroideAleatorio(int id, const EstatisticasAtributos& estatisticas, GeradorAleatorio& gerador){
+    vector<double> atributos;
 
-        random_device rd;
-        mt19937 gen(rd());
+    for(size_t i = 0; i < estatisticas.getDimensao(); i++){
+        double menor = estatisticas.menores[i];
+        double maior = estatisticas.maiores[i];
+        double desvioPadrao = estatisticas.getDesvioPadrao(i);
         double media = (menor + maior) / 2.0;
-        normal_distribution<double> dis(media, desvioPadrao);
 
+        // Box-Muller sobre o gerador de contador, para que a sequência não dependa da biblioteca padrão
         double temp;
         do{
-            temp = dis(gen);
+            double u1 = 1.0 - gerador.uniforme();
+            double u2 = gerador.uniforme();
+            temp = media + desvioPadrao * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
         } while((temp < menor) || (temp > maior));
 
         atributos.push_back(move(temp));
@@ -92,6 +80,20 @@ Centroide Centroide::criarCentroideAleatorio(int id, vector<Instancia> instancia
     return centroide;
 }
 
+// Lista "Centroide ID / Instancias" dos relatórios, com os ids formatados por to_chars
+static void escreverListaDeInstancias(const vector<Centroide>& centroides, EscritorAssincrono& arquivo) {
+    for (const Centroide& centroide : centroides) {
+        arquivo.escreverTexto("Centroide ID: ");
+        arquivo.escreverInteiro(centroide.getId());
+        arquivo.escreverTexto("\nInstancias: ");
+        for (const Instancia& instancia : centroide.getProximos()) {
+            arquivo.escreverInteiro(instancia.getId());
+            arquivo.escreverCaractere(' ');
+        }
+        arquivo.escreverCaractere('\n');
+    }
+}
+
 void Centroide::escreverCentroide(const vector<Centroide>& centroides, const string& nome_arquivo) {
     string pasta = "OutputTeste";
     fs::path directory = pasta;
@@ -106,22 +108,24 @@ void Centroide::escreverCentroide(const vector<Centroide>& centroides, const str
 
     fs::path caminho_arquivo = directory / nome_arquivo;
 
-    ofstream arquivo(caminho_arquivo);
+    EscritorAssincrono arquivo(caminho_arquivo.string());
 
-    if (!arquivo.is_open()) {
-        cerr << "Erro ao abrir o arquivo para escrita: " << caminho_arquivo << endl;
+    if (!arquivo.estaAberto()) {
         return;
     }
 
     for (const Centroide& centroide : centroides) {
-        arquivo << "Centroide ID: " << centroide.getId() << " - Atributos: ";
+        arquivo.escreverTexto("Centroide ID: ");
+        arquivo.escreverInteiro(centroide.getId());
+        arquivo.escreverTexto(" - Atributos: ");
         for (double atributo : centroide.getAtributos()) {
-            arquivo << fixed << setprecision(2) << atributo << " ";
+            arquivo.escreverReal(atributo, 2);
+            arquivo.escreverCaractere(' ');
         }
-        arquivo << endl;
+        arquivo.escreverCaractere('\n');
     }
 
-    arquivo.close();
+    arquivo.fechar();
 }
 
 void Centroide::adicionarInstancia(const Instancia& instancia){
@@ -142,23 +146,14 @@ void Centroide::escreverCentroidesComInstancias(const vector<Centroide>& centroi
 
     fs::path caminho_arquivo = directory / nome_arquivo;
 
-    ofstream arquivo(caminho_arquivo);
+    EscritorAssincrono arquivo(caminho_arquivo.string());
 
-    if (!arquivo.is_open()) {
-        cerr << "Erro ao abrir o arquivo para escrita: " << caminho_arquivo << endl;
+    if (!arquivo.estaAberto()) {
         return;
     }
 
-    for (const Centroide& centroide : centroides) {
-        arquivo << "Centroide ID: " << centroide.getId() << endl;
-        arquivo << "Instancias: ";
-        for (const Instancia& instancia : centroide.getProximos()) {
-            arquivo << instancia.getId() << " ";
-        }
-        arquivo << endl;
-    }
-
-    arquivo.close();
+    escreverListaDeInstancias(centroides, arquivo);
+    arquivo.fechar();
 }
 
 string getCurrentDatetime() {
@@ -174,7 +169,7 @@ string getCurrentDatetime() {
     return oss.str();
 }
 
-void Centroide::escreverCentroidesComInstancias(const vector<Centroide>& centroides, const vector<chrono::milliseconds>& durations, const vector<double>& indices) {
+void Centroide::escreverCentroidesComInstancias(const vector<Centroide>& centroides, const vector<chrono::milliseconds>& durations, const vector<double>& indices, const vector<string>& observacoes) {
     string pasta = "Output";
     fs::path directory = pasta;
 
@@ -188,34 +183,32 @@ void Centroide::escreverCentroidesComInstancias(const vector<Centroide>& centroi
 
     fs::path caminho_arquivo = directory / getCurrentDatetime();
 
-    ofstream arquivo(caminho_arquivo);
+    EscritorAssincrono arquivo(caminho_arquivo.string());
 
-    if (!arquivo.is_open()) {
-        cerr << "Erro ao abrir o arquivo para escrita: " << caminho_arquivo << endl;
+    if (!arquivo.estaAberto()) {
         return;
     }
 
-    arquivo << "K-Means Executado" << endl;
-    arquivo << "Informações Importantes: " << endl;
-    arquivo << "Tempo total de Execução: " << durations[0].count() << " milissegundos." << endl;
-    arquivo << "Tempo total para Instanciação: " << durations[1].count() << " milissegundos." << endl;
-    arquivo << "Tempo total para Clusterização: " << durations[2].count() << " milissegundos." << endl;
-    arquivo << "Indice de Silhouette: " << indices[0] << endl;
-    arquivo << "F-Measure: " << indices[1] << endl;
-    arquivo << "Davies-Boldin: " << indices[2] << endl;
-    arquivo << "Calinski-Harabasz: " << indices[3] << endl;
-    arquivo << "Adjusted Rand Index: " << indices[4] << endl << endl;
-
-    for (const Centroide& centroide : centroides) {
-        arquivo << "Centroide ID: " << centroide.getId() << endl;
-        arquivo << "Instancias: ";
-        for (const Instancia& instancia : centroide.getProximos()) {
-            arquivo << instancia.getId() << " ";
-        }
-        arquivo << endl;
+    // O cabeçalho é curto e mantém a formatação do iostream; a lista de instâncias vai pelo buffer
+    ostringstream cabecalho;
+    cabecalho << "K-Means Executado" << "\n";
+    cabecalho << "Informações Importantes: " << "\n";
+    cabecalho << "Tempo total de Execução: " << durations[0].count() << " milissegundos." << "\n";
+    cabecalho << "Tempo total para Instanciação: " << durations[1].count() << " milissegundos." << "\n";
+    cabecalho << "Tempo total para Clusterização: " << durations[2].count() << " milissegundos." << "\n";
+    cabecalho << "Indice de Silhouette: " << indices[0] << "\n";
+    cabecalho << "F-Measure: " << indices[1] << "\n";
+    cabecalho << "Davies-Boldin: " << indices[2] << "\n";
+    cabecalho << "Calinski-Harabasz: " << indices[3] << "\n";
+    cabecalho << "Adjusted Rand Index: " << indices[4] << "\n";
+    for (const string& observacao : observacoes) {
+        cabecalho << observacao << "\n";
     }
+    cabecalho << "\n";
+    arquivo.escreverTexto(cabecalho.str());
 
-    arquivo.close();
+    escreverListaDeInstancias(centroides, arquivo);
+    arquivo.fechar();
 }
 
 void Centroide::limparInstanciasProximas(){
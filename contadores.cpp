@@ -0,0 +1,197 @@
+#include "Library/contadores.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <cerrno>
+#include <chrono>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+PerfilHardware* PerfilHardware::atual = nullptr;
+
+LeituraContadores LeituraContadores::operator-(const LeituraContadores& outra) const {
+    LeituraContadores diferenca;
+    for (int i = 0; i < NUM_EVENTOS; ++i) {
+        diferenca.disponivel[i] = disponivel[i] && outra.disponivel[i];
+        diferenca.valores[i] = valores[i] >= outra.valores[i] ? valores[i] - outra.valores[i] : 0;
+    }
+    return diferenca;
+}
+
+LeituraContadores& LeituraContadores::operator+=(const LeituraContadores& outra) {
+    for (int i = 0; i < NUM_EVENTOS; ++i) {
+        disponivel[i] = disponivel[i] && outra.disponivel[i];
+        valores[i] += outra.valores[i];
+    }
+    return *this;
+}
+
+#ifdef __linux__
+// O evento de operações vetoriais é o FP_ARITH_INST_RETIRED (128 e 256 bits, simples e dupla) dos
+// processadores Intel; em outros fabricantes o mesmo código bruto mede outra coisa
+static bool processadorIntel() {
+    ifstream arquivo("/proc/cpuinfo");
+    string linha;
+    while (getline(arquivo, linha)) {
+        if (linha.rfind("vendor_id", 0) == 0) {
+            return linha.find("GenuineIntel") != string::npos;
+        }
+    }
+    return false;
+}
+
+static int abrirContador(uint32_t tipo, uint64_t configuracao) {
+    perf_event_attr atributos;
+    memset(&atributos, 0, sizeof(atributos));
+    atributos.size = sizeof(atributos);
+    atributos.type = tipo;
+    atributos.config = configuracao;
+    atributos.exclude_kernel = 1;
+    atributos.exclude_hv = 1;
+    // Threads criadas depois da abertura herdam o contador e entram na leitura do processo
+    atributos.inherit = 1;
+    atributos.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int) syscall(__NR_perf_event_open, &atributos, 0, -1, -1, 0);
+}
+#endif
+
+// Construtores
+PerfilHardware::PerfilHardware() : instanteMarca(0.0) {
+    for (int& descritor : descritores) {
+        descritor = -1;
+    }
+
+#ifdef __linux__
+    descritores[LeituraContadores::CICLOS] = abrirContador(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    if (descritores[LeituraContadores::CICLOS] < 0) {
+        motivoIndisponivel = strerror(errno);
+    }
+    descritores[LeituraContadores::INSTRUCOES] = abrirContador(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    descritores[LeituraContadores::FALTAS_LLC] = abrirContador(PERF_TYPE_HW_CACHE,
+        PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    if (descritores[LeituraContadores::FALTAS_LLC] < 0) {
+        descritores[LeituraContadores::FALTAS_LLC] = abrirContador(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    }
+    descritores[LeituraContadores::ERROS_DESVIO] = abrirContador(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    if (processadorIntel()) {
+        descritores[LeituraContadores::OPERACOES_VETORIAIS] = abrirContador(PERF_TYPE_RAW, 0x3CC7);
+    }
+#else
+    motivoIndisponivel = "perf_event_open existe apenas no Linux";
+#endif
+
+    atual = this;
+}
+
+PerfilHardware::~PerfilHardware() {
+    if (atual == this) {
+        atual = nullptr;
+    }
+#ifdef __linux__
+    for (int descritor : descritores) {
+        if (descritor >= 0) {
+            close(descritor);
+        }
+    }
+#endif
+}
+
+PerfilHardware* PerfilHardware::getAtual() {
+    return atual;
+}
+
+bool PerfilHardware::estaDisponivel() const {
+    return descritores[LeituraContadores::CICLOS] >= 0 || descritores[LeituraContadores::INSTRUCOES] >= 0;
+}
+
+LeituraContadores PerfilHardware::ler() const {
+    LeituraContadores leitura;
+#ifdef __linux__
+    for (int i = 0; i < LeituraContadores::NUM_EVENTOS; ++i) {
+        if (descritores[i] < 0) continue;
+
+        // Valor, tempo habilitado e tempo contando; com multiplexação o valor é extrapolado
+        uint64_t dados[3] = {};
+        if (read(descritores[i], dados, sizeof(dados)) != (ssize_t) sizeof(dados)) continue;
+        leitura.valores[i] = dados[2] > 0 && dados[2] < dados[1] ? (uint64_t) ((double) dados[0] * dados[1] / dados[2]) : dados[0];
+        leitura.disponivel[i] = true;
+    }
+#endif
+    return leitura;
+}
+
+static double agora() {
+    return chrono::duration<double, micro>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void PerfilHardware::marcar() {
+    marca = ler();
+    instanteMarca = agora();
+}
+
+void PerfilHardware::registrar(const string& fase) {
+    LeituraContadores leitura = ler();
+    double instante = agora();
+
+    auto encontrada = fases.find(fase);
+    if (encontrada == fases.end()) {
+        fasesEmOrdem.push_back(fase);
+        encontrada = fases.emplace(fase, Fase()).first;
+    }
+    // A primeira medição define quais eventos a fase tem; as seguintes só podem retirá-los
+    if (encontrada->second.medicoes == 0) {
+        encontrada->second.total = leitura - marca;
+    } else {
+        encontrada->second.total += leitura - marca;
+    }
+    encontrada->second.micros += instante - instanteMarca;
+    encontrada->second.medicoes++;
+
+    marca = leitura;
+    instanteMarca = instante;
+}
+
+vector<string> PerfilHardware::relatorio() const {
+    vector<string> linhas;
+    if (!estaDisponivel()) {
+        linhas.push_back("Contadores de hardware indisponiveis (" + motivoIndisponivel + ")");
+        return linhas;
+    }
+
+    for (const string& nome : fasesEmOrdem) {
+        const Fase& fase = fases.at(nome);
+        const LeituraContadores& total = fase.total;
+        ostringstream oss;
+        oss << fixed << setprecision(2) << "Contadores (" << nome << ", " << fase.medicoes << " medicoes, "
+            << fase.micros / 1000.0 << " ms):";
+        if (total.disponivel[LeituraContadores::CICLOS]) {
+            oss << " ciclos " << total.valores[LeituraContadores::CICLOS];
+        }
+        if (total.disponivel[LeituraContadores::CICLOS] && total.disponivel[LeituraContadores::INSTRUCOES] &&
+            total.valores[LeituraContadores::CICLOS] > 0) {
+            oss << ", IPC " << (double) total.valores[LeituraContadores::INSTRUCOES] / total.valores[LeituraContadores::CICLOS];
+        }
+        if (total.disponivel[LeituraContadores::FALTAS_LLC]) {
+            oss << ", faltas LLC " << total.valores[LeituraContadores::FALTAS_LLC];
+            if (fase.micros > 0.0) {
+                // Cada falta na LLC traz uma linha de 64 bytes da memória
+                oss << ", banda " << total.valores[LeituraContadores::FALTAS_LLC] * 64.0 / (fase.micros * 1000.0) << " GB/s";
+            }
+        }
+        if (total.disponivel[LeituraContadores::ERROS_DESVIO]) {
+            oss << ", erros de desvio " << total.valores[LeituraContadores::ERROS_DESVIO];
+        }
+        if (total.disponivel[LeituraContadores::OPERACOES_VETORIAIS]) {
+            oss << ", operacoes vetoriais " << total.valores[LeituraContadores::OPERACOES_VETORIAIS];
+        }
+        linhas.push_back(oss.str());
+    }
+    return linhas;
+}
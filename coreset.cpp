@@ -0,0 +1,111 @@
+#include "Library/coreset.h"
+#include "Library/aleatorio.h"
+#include "Library/soma.h"
+#include <future>
+#include <thread>
+#include <iterator>
+#include <algorithm>
+
+using namespace std;
+
+vector<Instancia> construirCoreset(const vector<Instancia>& instancias, size_t tamanho) {
+    return construirCoreset(instancias, tamanho, GeradorAleatorio::sementeAleatoria());
+}
+
+vector<Instancia> construirCoreset(const vector<Instancia>& instancias, size_t tamanho, uint64_t semente) {
+    if (instancias.empty() || tamanho >= instancias.size()) {
+        return instancias;
+    }
+
+    const size_t n = instancias.size();
+    const size_t d = instancias[0].getAtributos().size();
+    // Fatias alinhadas aos blocos da soma em árvore, para que a média não dependa do número de threads
+    const size_t numBlocos = SomaEmArvore::numBlocos(n);
+    size_t numThreads = max(1u, thread::hardware_concurrency());
+    size_t chunkSize = (numBlocos + numThreads - 1) / numThreads * SomaEmArvore::TAMANHO_BLOCO;
+
+    // Primeira passada: soma ponderada (d), soma dos quadrados e massa total por bloco
+    vector<future<vector<SomaEmArvore::No>>> futuresEstatisticas;
+    for (size_t inicio = 0; inicio < n; inicio += chunkSize) {
+        size_t fim = min(inicio + chunkSize, n);
+        futuresEstatisticas.push_back(async(launch::async, [&, inicio, fim]() {
+            SomaEmArvore::Pilha pilha(numBlocos);
+            for (size_t inicioBloco = inicio; inicioBloco < fim; inicioBloco += SomaEmArvore::TAMANHO_BLOCO) {
+                size_t fimBloco = min(inicioBloco + SomaEmArvore::TAMANHO_BLOCO, fim);
+                vector<double> parcial(d + 2, 0.0);
+                for (size_t i = inicioBloco; i < fimBloco; ++i) {
+                    const vector<double> atributos = instancias[i].getAtributos();
+                    double peso = instancias[i].getPeso();
+                    for (size_t j = 0; j < d; ++j) {
+                        parcial[j] += peso * atributos[j];
+                        parcial[d] += peso * atributos[j] * atributos[j];
+                    }
+                    parcial[d + 1] += peso;
+                }
+                pilha.adicionar(inicioBloco / SomaEmArvore::TAMANHO_BLOCO, move(parcial));
+            }
+            return move(pilha.getNos());
+        }));
+    }
+
+    vector<SomaEmArvore::No> nos;
+    for (auto& fut : futuresEstatisticas) {
+        vector<SomaEmArvore::No> parciais = fut.get();
+        nos.insert(nos.end(), make_move_iterator(parciais.begin()), make_move_iterator(parciais.end()));
+    }
+    vector<double> media = SomaEmArvore::combinar(move(nos), numBlocos, d + 2);
+    double somaQuadrados = media[d];
+    double massa = media[d + 1];
+    media.resize(d);
+
+    double normaMedia = 0.0;
+    for (double& valor : media) {
+        valor /= massa;
+        normaMedia += valor * valor;
+    }
+
+    // Soma das distâncias quadradas à média, sem uma passada extra: sum w||x||^2 - W||media||^2
+    double custoTotal = max(somaQuadrados - massa * normaMedia, 0.0);
+
+    // Segunda passada: amostragem de Bernoulli independente por instância, com o sorteio da
+    // instância i tirado da posição i do fluxo do coreset
+    vector<future<vector<Instancia>>> futuresAmostra;
+    for (size_t inicio = 0; inicio < n; inicio += chunkSize) {
+        size_t fim = min(inicio + chunkSize, n);
+        futuresAmostra.push_back(async(launch::async, [&, inicio, fim]() {
+            vector<Instancia> amostra;
+
+            for (size_t i = inicio; i < fim; ++i) {
+                const vector<double> atributos = instancias[i].getAtributos();
+                double peso = instancias[i].getPeso();
+
+                double distancia = 0.0;
+                for (size_t j = 0; j < d; ++j) {
+                    double diferenca = atributos[j] - media[j];
+                    distancia += diferenca * diferenca;
+                }
+
+                double q = 0.5 * peso / massa;
+                if (custoTotal > 0.0) {
+                    q += 0.5 * peso * distancia / custoTotal;
+                } else {
+                    q += 0.5 * peso / massa;
+                }
+
+                double probabilidade = min(1.0, tamanho * q);
+                if (GeradorAleatorio::uniforme(semente, FLUXO_CORESET, i) < probabilidade) {
+                    amostra.push_back(Instancia(instancias[i].getId(), atributos, peso / probabilidade));
+                }
+            }
+            return amostra;
+        }));
+    }
+
+    vector<Instancia> coreset;
+    for (auto& fut : futuresAmostra) {
+        vector<Instancia> amostra = fut.get();
+        coreset.insert(coreset.end(), make_move_iterator(amostra.begin()), make_move_iterator(amostra.end()));
+    }
+
+    return coreset;
+}
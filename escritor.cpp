@@ -0,0 +1,245 @@
+#include "Library/escritor.h"
+#include <charconv>
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+
+using namespace std;
+
+// Construtores
+EscritorAssincrono::EscritorAssincrono(const string& caminho, bool binario, size_t tamanhoBuffer, size_t maxPendentes)
+    : caminho(caminho), arquivo(caminho, binario ? ios::binary : ios::out), tamanhoBuffer(max<size_t>(tamanhoBuffer, 64)),
+      maxPendentes(max<size_t>(maxPendentes, 1)), encerrar(false), aberto(false), falhou(false), gravado(false) {
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir o arquivo para escrita: " << caminho << endl;
+        return;
+    }
+    aberto = true;
+    buffer.reserve(this->tamanhoBuffer);
+    trabalhador = thread(&EscritorAssincrono::executar, this);
+}
+
+EscritorAssincrono::~EscritorAssincrono() {
+    fechar();
+}
+
+bool EscritorAssincrono::estaAberto() const {
+    return aberto;
+}
+
+void EscritorAssincrono::executar() {
+    while (true) {
+        string pedaco;
+        {
+            unique_lock<mutex> lock(mtx);
+            sinal.wait(lock, [this]() { return !fila.empty() || encerrar; });
+            if (fila.empty()) return;
+            pedaco = move(fila.front());
+            fila.pop_front();
+        }
+        sinal.notify_all();
+        // Depois de uma falha a fila continua sendo esvaziada, para que o produtor não fique preso
+        if (!falhou && !arquivo.write(pedaco.data(), pedaco.size())) {
+            falhou = true;
+        }
+    }
+}
+
+void EscritorAssincrono::entregar() {
+    if (buffer.empty()) return;
+    {
+        unique_lock<mutex> lock(mtx);
+        sinal.wait(lock, [this]() { return fila.size() < maxPendentes; });
+        fila.push_back(move(buffer));
+    }
+    sinal.notify_all();
+    buffer = string();
+    buffer.reserve(tamanhoBuffer);
+}
+
+void EscritorAssincrono::escrever(const char* dados, size_t tamanho) {
+    if (!aberto) return;
+    while (tamanho > 0) {
+        size_t parte = min(tamanho, tamanhoBuffer - buffer.size());
+        buffer.append(dados, parte);
+        dados += parte;
+        tamanho -= parte;
+        if (buffer.size() >= tamanhoBuffer) {
+            entregar();
+        }
+    }
+}
+
+void EscritorAssincrono::escreverTexto(string_view texto) {
+    escrever(texto.data(), texto.size());
+}
+
+void EscritorAssincrono::escreverCaractere(char caractere) {
+    escrever(&caractere, 1);
+}
+
+void EscritorAssincrono::escreverInteiro(int64_t valor) {
+    char texto[24];
+    auto resultado = to_chars(texto, texto + sizeof(texto), valor);
+    escrever(texto, resultado.ptr - texto);
+}
+
+void EscritorAssincrono::escreverReal(double valor) {
+    char texto[32];
+    auto resultado = to_chars(texto, texto + sizeof(texto), valor);
+    escrever(texto, resultado.ptr - texto);
+}
+
+void EscritorAssincrono::escreverReal(double valor, int casas) {
+    // A notação fixa de valores muito grandes pode passar de 300 dígitos
+    char texto[400];
+    auto resultado = to_chars(texto, texto + sizeof(texto), valor, chars_format::fixed, casas);
+    if (resultado.ec != errc()) {
+        resultado = to_chars(texto, texto + sizeof(texto), valor);
+    }
+    escrever(texto, resultado.ptr - texto);
+}
+
+bool EscritorAssincrono::fechar() {
+    if (!aberto) return gravado;
+    entregar();
+    {
+        lock_guard<mutex> lock(mtx);
+        encerrar = true;
+    }
+    sinal.notify_all();
+    trabalhador.join();
+    arquivo.close();
+    aberto = false;
+
+    gravado = !falhou && arquivo;
+    if (!gravado) {
+        cerr << "Erro ao gravar o arquivo: " << caminho << endl;
+    }
+    return gravado;
+}
+
+constexpr char EscritorResultados::MAGICO[4];
+
+// Construtores
+EscritorResultados::EscritorResultados(const string& prefixo)
+    : binario(prefixo + ".bin", true), centroidesCsv(prefixo + ".centroides.csv"),
+      rotulosCsv(prefixo + ".rotulos.csv"), indicesCsv(prefixo + ".indices.csv") {
+}
+
+bool EscritorResultados::estaAberto() const {
+    return binario.estaAberto() && centroidesCsv.estaAberto() && rotulosCsv.estaAberto() && indicesCsv.estaAberto();
+}
+
+EscritorResultados::~EscritorResultados() {
+    // Sem get(): um erro da formatação não pode escapar do destrutor
+    if (particao.valid()) {
+        particao.wait();
+    }
+}
+
+// A formatação da partição inteira roda numa thread; os rótulos chegam como pares (id, cluster)
+void EscritorResultados::iniciarParticao(const vector<Centroide>& centroides, vector<pair<int32_t, int32_t>> rotulos) {
+    const uint64_t K = centroides.size();
+    const uint64_t d = K > 0 ? centroides[0].getAtributos().size() : 0;
+    vector<int32_t> idsCentroides;
+    vector<double> posicoes;
+    posicoes.reserve(K * d);
+    for (const Centroide& centroide : centroides) {
+        idsCentroides.push_back(centroide.getId());
+        const vector<double> atributos = centroide.getAtributos();
+        posicoes.insert(posicoes.end(), atributos.begin(), atributos.end());
+    }
+
+    aguardarParticao();
+    particao = async(launch::async, [this, K, d, idsCentroides = move(idsCentroides), posicoes = move(posicoes), rotulos = move(rotulos)]() {
+        const uint64_t n = rotulos.size();
+        binario.escrever(MAGICO, sizeof(MAGICO));
+        binario.escreverBinario(VERSAO);
+        binario.escreverBinario(K);
+        binario.escreverBinario(d);
+        binario.escreverBinario(n);
+        binario.escreverBinario(posicoes);
+
+        centroidesCsv.escreverTexto("cluster");
+        for (uint64_t j = 0; j < d; ++j) {
+            centroidesCsv.escreverTexto(",a");
+            centroidesCsv.escreverInteiro(j);
+        }
+        centroidesCsv.escreverCaractere('\n');
+        for (uint64_t k = 0; k < K; ++k) {
+            centroidesCsv.escreverInteiro(idsCentroides[k]);
+            for (uint64_t j = 0; j < d; ++j) {
+                centroidesCsv.escreverCaractere(',');
+                centroidesCsv.escreverReal(posicoes[k * d + j]);
+            }
+            centroidesCsv.escreverCaractere('\n');
+        }
+
+        rotulosCsv.escreverTexto("id,cluster\n");
+        for (const auto& [id, cluster] : rotulos) {
+            binario.escreverBinario(id);
+            binario.escreverBinario(cluster);
+
+            rotulosCsv.escreverInteiro(id);
+            rotulosCsv.escreverCaractere(',');
+            rotulosCsv.escreverInteiro(cluster);
+            rotulosCsv.escreverCaractere('\n');
+        }
+    });
+}
+
+void EscritorResultados::aguardarParticao() {
+    if (particao.valid()) {
+        particao.get();
+    }
+}
+
+void EscritorResultados::escreverParticao(const vector<Centroide>& centroides) {
+    size_t n = 0;
+    for (const Centroide& centroide : centroides) {
+        n += centroide.getProximos().size();
+    }
+
+    // Rótulos na ordem dos clusters, como as instâncias próximas de cada centroide
+    vector<pair<int32_t, int32_t>> rotulos;
+    rotulos.reserve(n);
+    for (const Centroide& centroide : centroides) {
+        for (const Instancia& instancia : centroide.getProximos()) {
+            rotulos.push_back({instancia.getId(), centroide.getId()});
+        }
+    }
+    iniciarParticao(centroides, move(rotulos));
+}
+
+void EscritorResultados::escreverParticao(const vector<Centroide>& centroides, const vector<int>& ids, const vector<int>& rotulos) {
+    vector<pair<int32_t, int32_t>> pares(rotulos.size());
+    for (size_t i = 0; i < rotulos.size(); ++i) {
+        pares[i] = {ids[i], centroides[rotulos[i]].getId()};
+    }
+    iniciarParticao(centroides, move(pares));
+}
+
+void EscritorResultados::escreverIndices(const vector<string>& nomes, const vector<double>& valores) {
+    // No binário os índices vêm depois da partição
+    aguardarParticao();
+    binario.escreverBinario(static_cast<uint32_t>(valores.size()));
+    binario.escreverBinario(valores);
+
+    indicesCsv.escreverTexto("indice,valor\n");
+    for (size_t i = 0; i < valores.size(); ++i) {
+        indicesCsv.escreverTexto(i < nomes.size() ? nomes[i] : "indice" + to_string(i));
+        indicesCsv.escreverCaractere(',');
+        indicesCsv.escreverReal(valores[i]);
+        indicesCsv.escreverCaractere('\n');
+    }
+}
+
+bool EscritorResultados::fechar() {
+    aguardarParticao();
+    bool gravado = binario.fechar();
+    gravado = centroidesCsv.fechar() && gravado;
+    gravado = rotulosCsv.fechar() && gravado;
+    gravado = indicesCsv.fechar() && gravado;
+    return gravado;
+}
@@ -0,0 +1,268 @@
+#include "Library/esparso.h"
+#include "Library/soma.h"
+#include <future>
+#include <thread>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <iterator>
+#include <fstream>
+#include <iostream>
+#include <charconv>
+#include <cctype>
+#include <string_view>
+
+using namespace std;
+
+// Construtores
+DadosEsparsos::DadosEsparsos(size_t dimensao) : dimensao(dimensao), inicioLinhas(1, 0) {}
+
+// Getters
+size_t DadosEsparsos::getNumInstancias() const {
+    return inicioLinhas.size() - 1;
+}
+
+size_t DadosEsparsos::getDimensao() const {
+    return dimensao;
+}
+
+size_t DadosEsparsos::getNumNaoNulos() const {
+    return valores.size();
+}
+
+const vector<int>& DadosEsparsos::getIds() const {
+    return ids;
+}
+
+vector<double> DadosEsparsos::getLinhaDensa(size_t i) const {
+    vector<double> linha(dimensao, 0.0);
+    for (size_t p = inicioLinhas[i]; p < inicioLinhas[i + 1]; ++p) {
+        linha[colunas[p]] = valores[p];
+    }
+    return linha;
+}
+
+void DadosEsparsos::adicionarLinha(int id, const vector<pair<int, double>>& entradas, double peso) {
+    double norma = 0.0;
+    for (const auto& entrada : entradas) {
+        if (entrada.second == 0.0) continue;
+        if (entrada.first < 0) {
+            throw invalid_argument("Indice de coluna negativo na linha " + to_string(id));
+        }
+        colunas.push_back(entrada.first);
+        valores.push_back(entrada.second);
+        norma += entrada.second * entrada.second;
+        dimensao = max(dimensao, (size_t) entrada.first + 1);
+    }
+
+    inicioLinhas.push_back(valores.size());
+    normasLinhas.push_back(norma);
+    pesos.push_back(peso);
+    ids.push_back(id);
+}
+
+DadosEsparsos DadosEsparsos::lerSvmLight(const string& caminho) {
+    DadosEsparsos dados;
+    ifstream arquivo(caminho);
+
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir o arquivo: " << caminho << endl;
+        return dados;
+    }
+
+    string linha;
+    vector<pair<int, double>> entradas;
+    size_t numeroLinha = 0;
+    int id = 0;
+    while (getline(arquivo, linha)) {
+        ++numeroLinha;
+        size_t comentario = linha.find('#');
+        if (comentario != string::npos) {
+            linha.resize(comentario);
+        }
+
+        const char* p = linha.data();
+        const char* fim = p + linha.size();
+        auto pularEspacos = [&]() {
+            while (p < fim && isspace(static_cast<unsigned char>(*p))) ++p;
+        };
+        auto pularCampo = [&]() {
+            while (p < fim && !isspace(static_cast<unsigned char>(*p))) ++p;
+        };
+
+        pularEspacos();
+        if (p == fim) continue;
+        // O primeiro campo é o rótulo da classe
+        pularCampo();
+
+        entradas.clear();
+        while (true) {
+            pularEspacos();
+            if (p == fim) break;
+            if (fim - p > 4 && string_view(p, 4) == "qid:") {
+                pularCampo();
+                continue;
+            }
+
+            int indice = 0;
+            double valor = 0.0;
+            from_chars_result resultado = from_chars(p, fim, indice);
+            if (resultado.ec != errc() || resultado.ptr == fim || *resultado.ptr != ':' || indice < 1) {
+                throw runtime_error("Entrada invalida na linha " + to_string(numeroLinha) + " de " + caminho);
+            }
+            resultado = from_chars(resultado.ptr + 1, fim, valor);
+            if (resultado.ec != errc()) {
+                throw runtime_error("Valor invalido na linha " + to_string(numeroLinha) + " de " + caminho);
+            }
+            p = resultado.ptr;
+            entradas.push_back({indice - 1, valor});
+        }
+
+        dados.adicionarLinha(id++, entradas);
+    }
+
+    arquivo.close();
+    return dados;
+}
+
+DadosEsparsos DadosEsparsos::deInstancias(const vector<Instancia>& instancias) {
+    DadosEsparsos dados(instancias.empty() ? 0 : instancias[0].getAtributos().size());
+
+    for (const Instancia& instancia : instancias) {
+        const vector<double> atributos = instancia.getAtributos();
+        vector<pair<int, double>> entradas;
+        for (size_t j = 0; j < atributos.size(); ++j) {
+            if (atributos[j] != 0.0) {
+                entradas.push_back({(int) j, atributos[j]});
+            }
+        }
+        dados.adicionarLinha(instancia.getId(), entradas, instancia.getPeso());
+    }
+
+    return dados;
+}
+
+void DadosEsparsos::atribuir(const vector<Centroide>& centroides, Atribuicao& atribuicao) {
+    const size_t K = centroides.size();
+    const size_t d = dimensao;
+    const size_t n = getNumInstancias();
+
+    // Centroides contíguos e as suas normas, calculadas uma vez por passada
+    vector<double> matriz(K * d);
+    vector<double> normasCentroides(K, 0.0);
+    for (size_t k = 0; k < K; ++k) {
+        const vector<double> atributos = centroides[k].getAtributos();
+        copy(atributos.begin(), atributos.end(), matriz.begin() + k * d);
+        for (double valor : atributos) {
+            normasCentroides[k] += valor * valor;
+        }
+    }
+
+    // Rótulos -1 na primeira passada: todas as instâncias contam como mudança
+    if (atribuicao.rotulos.size() != n) {
+        atribuicao.rotulos.assign(n, -1);
+    }
+    atribuicao.distancias.resize(n);
+
+    // Fatias alinhadas aos blocos da soma em árvore, para que a redução não dependa do número de threads
+    const size_t numBlocos = SomaEmArvore::numBlocos(n);
+    size_t numThreads = max(1u, thread::hardware_concurrency());
+    size_t blocosPorThread = (numBlocos + numThreads - 1) / numThreads;
+    size_t chunkSize = max<size_t>(1, blocosPorThread) * SomaEmArvore::TAMANHO_BLOCO;
+
+    struct Parcial {
+        vector<SomaEmArvore::No> nos;
+        vector<int> contagens;
+        size_t mudancas;
+    };
+    vector<future<Parcial>> futures;
+
+    for (size_t inicio = 0; inicio < n; inicio += chunkSize) {
+        size_t fim = min(inicio + chunkSize, n);
+        futures.push_back(async(launch::async, [&, inicio, fim]() {
+            SomaEmArvore::Pilha pilha(numBlocos);
+            vector<int> contagens(K, 0);
+            size_t mudancas = 0;
+            const size_t posicaoMassas = K * d;
+            const size_t posicaoInercia = K * d + K;
+            vector<pair<size_t, double>> contribuicoes;
+
+            for (size_t inicioBloco = inicio; inicioBloco < fim; inicioBloco += SomaEmArvore::TAMANHO_BLOCO) {
+                size_t fimBloco = min(inicioBloco + SomaEmArvore::TAMANHO_BLOCO, fim);
+
+                // Parcial esparsa do bloco sobre o vetor somas (K x d), massas (K) e inércia: só as
+                // posições tocadas pelos não nulos, em vez de K x d valores por bloco
+                contribuicoes.clear();
+
+                for (size_t i = inicioBloco; i < fimBloco; ++i) {
+                    size_t primeiro = inicioLinhas[i];
+                    size_t ultimo = inicioLinhas[i + 1];
+                    size_t indiceCentroideProximo = 0;
+                    double menorDistancia = numeric_limits<double>::max();
+
+                    for (size_t k = 0; k < K; ++k) {
+                        const double* centroide = matriz.data() + k * d;
+                        double produto = 0.0;
+                        for (size_t e = primeiro; e < ultimo; ++e) {
+                            produto += valores[e] * centroide[colunas[e]];
+                        }
+                        double distancia = normasLinhas[i] - 2.0 * produto + normasCentroides[k];
+                        if (distancia < menorDistancia) {
+                            menorDistancia = distancia;
+                            indiceCentroideProximo = k;
+                        }
+                    }
+
+                    // Apenas as entradas não nulas são espalhadas nas somas do cluster
+                    mudancas += atribuicao.rotulos[i] != (int) indiceCentroideProximo;
+                    atribuicao.rotulos[i] = indiceCentroideProximo;
+                    atribuicao.distancias[i] = max(menorDistancia, 0.0);
+                    contribuicoes.push_back({posicaoInercia, pesos[i] * atribuicao.distancias[i]});
+                    contagens[indiceCentroideProximo]++;
+                    contribuicoes.push_back({posicaoMassas + indiceCentroideProximo, pesos[i]});
+                    size_t inicioSoma = indiceCentroideProximo * d;
+                    for (size_t e = primeiro; e < ultimo; ++e) {
+                        contribuicoes.push_back({inicioSoma + colunas[e], pesos[i] * valores[e]});
+                    }
+                }
+
+                // A ordenação estável mantém, em cada posição, a ordem das linhas da soma densa
+                stable_sort(contribuicoes.begin(), contribuicoes.end(),
+                            [](const pair<size_t, double>& a, const pair<size_t, double>& b) { return a.first < b.first; });
+                vector<size_t> indices;
+                vector<double> parcial;
+                for (const auto& contribuicao : contribuicoes) {
+                    if (!indices.empty() && indices.back() == contribuicao.first) {
+                        parcial.back() += contribuicao.second;
+                    } else {
+                        indices.push_back(contribuicao.first);
+                        parcial.push_back(contribuicao.second);
+                    }
+                }
+
+                pilha.adicionarEsparso(inicioBloco / SomaEmArvore::TAMANHO_BLOCO, move(indices), move(parcial));
+            }
+            return Parcial{move(pilha.getNos()), move(contagens), mudancas};
+        }));
+    }
+
+    vector<SomaEmArvore::No> nos;
+    atribuicao.contagens.assign(K, 0);
+    atribuicao.mudancas = 0;
+    for (auto& fut : futures) {
+        Parcial parcial = fut.get();
+        atribuicao.mudancas += parcial.mudancas;
+        nos.insert(nos.end(), make_move_iterator(parcial.nos.begin()), make_move_iterator(parcial.nos.end()));
+        for (size_t k = 0; k < K; ++k) {
+            atribuicao.contagens[k] += parcial.contagens[k];
+        }
+    }
+
+    vector<double> total = SomaEmArvore::combinar(move(nos), numBlocos, K * d + K + 1);
+    atribuicao.inercia = total[K * d + K];
+    atribuicao.distanciasCalculadas = n * K;
+    atribuicao.distanciasEvitadas = 0;
+    atribuicao.massas.assign(total.begin() + K * d, total.begin() + K * d + K);
+    total.resize(K * d);
+    atribuicao.somas = move(total);
+}
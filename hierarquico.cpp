@@ -0,0 +1,201 @@
+#include "Library/hierarquico.h"
+#include "Library/kmeans.h"
+#include <future>
+#include <thread>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+// Getters
+const vector<ArvoreKmeans::No>& ArvoreKmeans::getNos() const {
+    return nos;
+}
+
+int ArvoreKmeans::getNumFolhas() const {
+    return folhas.size();
+}
+
+vector<Centroide> ArvoreKmeans::getCentroides() const {
+    vector<Centroide> centroides;
+    for (size_t i = 0; i < folhas.size(); ++i) {
+        centroides.push_back(Centroide(i, nos[folhas[i]].atributos, {}));
+    }
+    return centroides;
+}
+
+// Média ponderada e SSE das instâncias indicadas
+ArvoreKmeans::No criarNo(const vector<Instancia>& instancias, vector<int> indices) {
+    ArvoreKmeans::No no;
+    size_t d = instancias[0].getAtributos().size();
+    no.atributos.assign(d, 0.0);
+    no.sse = 0.0;
+    no.folha = -1;
+
+    double massa = 0.0;
+    for (int indice : indices) {
+        const vector<double> atributos = instancias[indice].getAtributos();
+        double peso = instancias[indice].getPeso();
+        for (size_t j = 0; j < d; ++j) {
+            no.atributos[j] += peso * atributos[j];
+        }
+        massa += peso;
+    }
+    for (double& valor : no.atributos) {
+        valor /= massa;
+    }
+
+    for (int indice : indices) {
+        const vector<double> atributos = instancias[indice].getAtributos();
+        double distancia = 0.0;
+        for (size_t j = 0; j < d; ++j) {
+            double diferenca = atributos[j] - no.atributos[j];
+            distancia += diferenca * diferenca;
+        }
+        no.sse += instancias[indice].getPeso() * distancia;
+    }
+
+    no.indices = move(indices);
+    return no;
+}
+
+ArvoreKmeans ArvoreKmeans::construir(vector<Instancia>& instancias, int K, int ramificacao) {
+    return construir(instancias, K, ramificacao, GeradorAleatorio::sementeAleatoria());
+}
+
+ArvoreKmeans ArvoreKmeans::construir(vector<Instancia>& instancias, int K, int ramificacao, uint64_t semente) {
+    if (instancias.empty()) {
+        throw invalid_argument("A base de dados esta vazia.");
+    }
+    if (ramificacao < 2) {
+        throw invalid_argument("O fator de ramificacao deve ser pelo menos 2.");
+    }
+
+    ArvoreKmeans arvore;
+    TopologiaNuma topologia = TopologiaNuma::detectar();
+
+    vector<int> todos(instancias.size());
+    for (size_t i = 0; i < instancias.size(); ++i) {
+        todos[i] = i;
+    }
+    arvore.nos.push_back(criarNo(instancias, move(todos)));
+    arvore.folhas.push_back(0);
+
+    // Folhas que não puderam ser divididas (todas as instâncias iguais, por exemplo)
+    vector<bool> indivisivel(1, false);
+
+    while (arvore.folhas.size() < (size_t) K) {
+        int escolhida = -1;
+        for (size_t f = 0; f < arvore.folhas.size(); ++f) {
+            const No& no = arvore.nos[arvore.folhas[f]];
+            if (indivisivel[arvore.folhas[f]] || no.indices.size() < 2 || no.sse <= 0.0) continue;
+            if (escolhida == -1 || no.sse > arvore.nos[arvore.folhas[escolhida]].sse) {
+                escolhida = f;
+            }
+        }
+        if (escolhida == -1) break;
+
+        int pai = arvore.folhas[escolhida];
+        vector<int> indices = arvore.nos[pai].indices;
+        int numFilhos = min<int>({ramificacao, K - (int) arvore.folhas.size() + 1, (int) indices.size()});
+
+        // Lloyd apenas sobre o subconjunto do cluster escolhido
+        vector<Instancia> subconjunto;
+        for (int indice : indices) {
+            subconjunto.push_back(instancias[indice]);
+        }
+        DadosNuma dados(subconjunto, topologia);
+        Atribuicao atribuicao;
+
+        // Cada divisão tem a sua semente, derivada do nó dividido
+        uint64_t sementeDivisao = GeradorAleatorio::gerar(semente, FLUXO_HIERARQUICO + pai, 0);
+        vector<Centroide> filhos = criarCentroidesAleatorios(numFilhos, subconjunto, sementeDivisao);
+        executarLloyd(filhos, subconjunto, dados, atribuicao, sementeDivisao);
+        calcularCentroidesProximos(filhos, subconjunto, dados, atribuicao, 0);
+
+        vector<vector<int>> indicesFilhos(numFilhos);
+        for (size_t i = 0; i < indices.size(); ++i) {
+            indicesFilhos[atribuicao.rotulos[i]].push_back(indices[i]);
+        }
+
+        vector<int> novosNos;
+        for (auto& indicesFilho : indicesFilhos) {
+            if (indicesFilho.empty()) continue;
+            novosNos.push_back(arvore.nos.size());
+            arvore.nos.push_back(criarNo(instancias, move(indicesFilho)));
+            indivisivel.push_back(false);
+        }
+
+        if (novosNos.size() < 2) {
+            arvore.nos.resize(arvore.nos.size() - novosNos.size());
+            indivisivel.resize(arvore.nos.size());
+            indivisivel[pai] = true;
+            continue;
+        }
+
+        arvore.nos[pai].filhos = novosNos;
+        arvore.nos[pai].indices.clear();
+        arvore.folhas.erase(arvore.folhas.begin() + escolhida);
+        arvore.folhas.insert(arvore.folhas.end(), novosNos.begin(), novosNos.end());
+    }
+
+    for (size_t f = 0; f < arvore.folhas.size(); ++f) {
+        arvore.nos[arvore.folhas[f]].folha = f;
+        arvore.nos[arvore.folhas[f]].indices.clear();
+    }
+
+    return arvore;
+}
+
+int ArvoreKmeans::atribuir(const vector<double>& atributos) const {
+    int atual = 0;
+
+    while (!nos[atual].filhos.empty()) {
+        int melhor = -1;
+        double menorDistancia = numeric_limits<double>::max();
+
+        for (int filho : nos[atual].filhos) {
+            const vector<double>& centroide = nos[filho].atributos;
+            double distancia = 0.0;
+            for (size_t j = 0; j < atributos.size(); ++j) {
+                double diferenca = atributos[j] - centroide[j];
+                distancia += diferenca * diferenca;
+            }
+            if (distancia < menorDistancia) {
+                menorDistancia = distancia;
+                melhor = filho;
+            }
+        }
+        atual = melhor;
+    }
+
+    return nos[atual].folha;
+}
+
+void ArvoreKmeans::atribuirInstancias(vector<Centroide>& centroides, const vector<Instancia>& instancias) const {
+    vector<int> rotulos(instancias.size());
+    size_t numThreads = max(1u, thread::hardware_concurrency());
+    size_t chunkSize = (instancias.size() + numThreads - 1) / numThreads;
+    vector<future<void>> futures;
+
+    for (size_t inicio = 0; inicio < instancias.size(); inicio += chunkSize) {
+        size_t fim = min(inicio + chunkSize, instancias.size());
+        futures.push_back(async(launch::async, [&, inicio, fim]() {
+            for (size_t i = inicio; i < fim; ++i) {
+                rotulos[i] = atribuir(instancias[i].getAtributos());
+            }
+        }));
+    }
+
+    for (auto& fut : futures) {
+        fut.get();
+    }
+
+    for (auto& centroide : centroides) {
+        centroide.limparInstanciasProximas();
+    }
+    for (size_t i = 0; i < instancias.size(); ++i) {
+        centroides[rotulos[i]].adicionarInstancia(instancias[i]);
+    }
+}
@@ -1,4 +1,14 @@
 #include "Library/kmeans.h"
+#include "Library/coreset.h"
+#include "Library/hierarquico.h"
+#include "Library/modelo.h"
+#include "Library/esparso.h"
+#include "Library/reducao.h"
+#include "Library/quantizado.h"
+#include "Library/rastreamento.h"
+#include "Library/contadores.h"
+#include "Library/escritor.h"
+#include "Library/seletor.h"
 #include <thread>
 #include <future>
 #include <mutex>
@@ -10,24 +20,44 @@
 #include <set>
 #include <stdexcept>
 #include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <sstream>
 
 vector<Centroide> criarCentroidesAleatorios(int numeroK, vector<Instancia>& instancias){
+   return criarCentroidesAleatorios(numeroK, instancias, GeradorAleatorio::sementeAleatoria());
+}
+
+// As estatísticas dos atributos são calculadas uma única vez para todos os centroides
+vector<Centroide> criarCentroidesAleatorios(int numeroK, vector<Instancia>& instancias, uint64_t semente){
+   return criarCentroidesAleatorios(numeroK, EstatisticasAtributos::calcular(instancias), semente);
+}
+
+// Cada centroide sorteia do seu próprio fluxo, então o resultado só depende da semente
+vector<Centroide> criarCentroidesAleatorios(int numeroK, const EstatisticasAtributos& estatisticas, uint64_t semente){
    vector<Centroide> centroides;
-   vector<future<Centroide>> futures;
-   mutex mutex;
 
    for (int i = 0; i < numeroK; ++i) {
-      futures.push_back(async(launch::async, [i, &instancias]() {
-         return Centroide::criarCentroideAleatorio(i, instancias);
-      }));
+      GeradorAleatorio gerador(semente, FLUXO_CENTROIDES + i);
+      centroides.push_back(Centroide::criarCentroideAleatorio(i, estatisticas, gerador));
    }
 
-   for (auto& fut : futures) {
-      Centroide centroide = fut.get();
-      lock_guard<std::mutex> lock(mutex);
-      centroides.push_back(move(centroide));
+   return centroides;
+}
+
+vector<size_t> amostrarInstancias(size_t numInstancias, size_t tamanho, uint64_t semente){
+   Reservatorio reservatorio(tamanho, semente);
+   for (size_t i = 0; i < numInstancias; ++i) {
+      reservatorio.oferecer(i);
    }
+   return reservatorio.getIndices();
+}
 
+vector<Centroide> criarCentroidesDaAmostra(const vector<Instancia>& instancias, const vector<size_t>& amostra){
+   vector<Centroide> centroides;
+   for (size_t i = 0; i < amostra.size(); ++i) {
+      centroides.emplace_back(i, instancias[amostra[i]].getAtributos(), vector<Instancia>());
+   }
    return centroides;
 }
 
@@ -92,6 +122,62 @@ void calcularCentroidesProximos(vector<Centroide>& centroides, const vector<Inst
     } while (needsRecalculation);
 }
 
+// A passada de atribuição fica a cargo da representação dos dados; aqui são preenchidas as
+// instâncias próximas e, no estado 1, tratados os centroides que ficaram vazios: com
+// VAZIO_REINICIAR cada um é sorteado do fluxo (rodada, centroide) da semente e a passada é
+// refeita; as demais políticas corrigem a atribuição localmente, sem nova passada.
+void calcularCentroidesProximos(vector<Centroide>& centroides, const vector<Instancia>& instancias, DadosAtribuicao& dados, Atribuicao& atribuicao, int estado, uint64_t semente, PoliticaVazio politica) {
+    bool needsRecalculation;
+    uint64_t rodada = 0;
+
+    do {
+        needsRecalculation = false;
+        dados.atribuir(centroides, atribuicao);
+
+        if (estado == 1 && politica != VAZIO_REINICIAR) {
+            repararClustersVazios(centroides, instancias, atribuicao, politica, semente, rodada++);
+        }
+
+        for (auto& centroide : centroides) {
+            centroide.limparInstanciasProximas();
+        }
+        for (size_t i = 0; i < instancias.size(); ++i) {
+            centroides[atribuicao.rotulos[i]].adicionarInstancia(instancias[i]);
+        }
+
+        // Sem as instâncias (base esparsa lida do arquivo) não há de onde sortear o substituto
+        if(estado == 1 && politica == VAZIO_REINICIAR && !instancias.empty()){
+            // Reinicializar centróides sem instâncias e marcar que precisamos recalcular
+            for (auto& centroide : centroides) {
+                if (centroide.getProximos().size() == 0) {
+                    GeradorAleatorio gerador(semente, FLUXO_REINICIO + rodada * centroides.size() + centroide.getId());
+                    centroide = Centroide::criarCentroideAleatorio(centroide.getId(), instancias, gerador);
+                    needsRecalculation = true;
+                }
+            }
+            rodada++;
+        }
+    } while (needsRecalculation);
+}
+
+void atualizarCentroides(vector<Centroide>& centroides, const Atribuicao& atribuicao) {
+    const size_t K = centroides.size();
+    const size_t d = atribuicao.somas.size() / K;
+
+    for (size_t k = 0; k < K; ++k) {
+        if (atribuicao.contagens[k] == 0 || atribuicao.massas[k] <= 0.0) continue;
+
+        // Média ponderada pelos pesos das instâncias (peso 1 reproduz a média simples)
+        vector<double> novaMedia(atribuicao.somas.begin() + k * d, atribuicao.somas.begin() + (k + 1) * d);
+        for (double& valor : novaMedia) {
+            valor /= atribuicao.massas[k];
+        }
+
+        centroides[k].setAtributos(novaMedia);
+        centroides[k].limparInstanciasProximas();
+    }
+}
+
 void atualizarCentroides(vector<Centroide>& centroides) {
     vector<future<void>> futures;
     mutex mtx;
@@ -127,46 +213,24 @@ void atualizarCentroides(vector<Centroide>& centroides) {
     }
 }
 
+// Comparação direta: K vetores não justificam disparar threads
 bool verificarConvergencia(const vector<Centroide>& centroides, const vector<Centroide>& centroidesAntigos, double tolerancia = 1e-6) {
     if (centroides.size() != centroidesAntigos.size()) {
         throw invalid_argument("Os vetores de centroides atuais e antigos devem ter o mesmo tamanho.");
     }
 
-    auto verificarCentroide = [&](size_t start, size_t end) {
-        for (size_t i = start; i < end; ++i) {
-            const vector<double>& atributosAntigos = centroidesAntigos[i].getAtributos();
-            const vector<double>& atributos = centroides[i].getAtributos();
-
-            if (atributos.size() != atributosAntigos.size()) {
-                throw invalid_argument("Os vetores de atributos dos centroides devem ter o mesmo tamanho.");
-            }
-
-            for (size_t j = 0; j < atributos.size(); ++j) {
-                if (abs(atributos[j] - atributosAntigos[j]) > tolerancia) {
-                    return false;
-                }
-            }
-        }
-        return true;
-    };
-
-    size_t numThreads = thread::hardware_concurrency();
-    size_t tamanho = centroides.size();
-    size_t chunkSize = (tamanho + numThreads - 1) / numThreads;  // Divisão arredondada para cima
-
-    vector<future<bool>> futures;
+    for (size_t i = 0; i < centroides.size(); ++i) {
+        const vector<double>& atributosAntigos = centroidesAntigos[i].getAtributos();
+        const vector<double>& atributos = centroides[i].getAtributos();
 
-    for (size_t i = 0; i < numThreads; ++i) {
-        size_t start = i * chunkSize;
-        size_t end = min(start + chunkSize, tamanho);
-        if (start < end) {
-            futures.push_back(async(launch::async, verificarCentroide, start, end));
+        if (atributos.size() != atributosAntigos.size()) {
+            throw invalid_argument("Os vetores de atributos dos centroides devem ter o mesmo tamanho.");
         }
-    }
 
-    for (auto& fut : futures) {
-        if (!fut.get()) {
-            return false;
+        for (size_t j = 0; j < atributos.size(); ++j) {
+            if (abs(atributos[j] - atributosAntigos[j]) > tolerancia) {
+                return false;
+            }
         }
     }
 
@@ -197,20 +261,24 @@ Centroide calcularCentroideMaisProximo(vector<Centroide>& centroides, const Inst
 
 double silhouetteMeasure(const vector<Centroide>& centroides) {
     vector<double> silhouettesA;
+    vector<double> pesos;
 
     for (const Centroide& centroide : centroides) {
         vector<Instancia> instancias = centroide.getProximos();
 
         for (size_t i = 0; i < instancias.size(); ++i) {
             double distanciaTotal = 0.0;
+            double massaTotal = 0.0;
 
             for (size_t j = 0; j < instancias.size(); ++j) {
                 if (i != j) {
                     double distanciaTemp = calcularDistanciaEuclidiana(instancias[i].getAtributos(), instancias[j].getAtributos());
-                    distanciaTotal += distanciaTemp;
+                    distanciaTotal += instancias[j].getPeso() * distanciaTemp;
+                    massaTotal += instancias[j].getPeso();
                 }
             }
-            silhouettesA.push_back(distanciaTotal / (instancias.size() - 1));
+            silhouettesA.push_back(distanciaTotal / massaTotal);
+            pesos.push_back(instancias[i].getPeso());
         }
     }
 
@@ -231,12 +299,14 @@ double silhouetteMeasure(const vector<Centroide>& centroides) {
             Centroide centroideProximo = calcularCentroideMaisProximo(centroidesTemp, instancias[j]);
             vector<Instancia> instanciasProximas = centroideProximo.getProximos();
             double distanciaTotal = 0.0;
+            double massaTotal = 0.0;
 
             for (size_t k = 0; k < instanciasProximas.size(); ++k) {
                 double temp = calcularDistanciaEuclidiana(instancias[j].getAtributos(), instanciasProximas[k].getAtributos());
-                distanciaTotal += temp;
+                distanciaTotal += instanciasProximas[k].getPeso() * temp;
+                massaTotal += instanciasProximas[k].getPeso();
             }
-            silhouettesB.push_back(distanciaTotal / instanciasProximas.size());
+            silhouettesB.push_back(distanciaTotal / massaTotal);
         }
     }
 
@@ -244,12 +314,177 @@ double silhouetteMeasure(const vector<Centroide>& centroides) {
 
     for (size_t i = 0; i < silhouettesA.size(); ++i) {
         double temp = (silhouettesB[i] - silhouettesA[i]) / max(silhouettesA[i], silhouettesB[i]);
-        silhouette.push_back(temp);
+        silhouette.push_back(pesos[i] * temp);
     }
 
     double media = accumulate(silhouette.begin(), silhouette.end(), 0.0);
 
-    return media / silhouette.size();
+    return media / accumulate(pesos.begin(), pesos.end(), 0.0);
+}
+
+int executarLloyd(vector<Centroide>& centroides, vector<Instancia>& instancias, DadosAtribuicao& dados, Atribuicao& atribuicao) {
+    return executarLloyd(centroides, instancias, dados, atribuicao, GeradorAleatorio::sementeAleatoria());
+}
+
+// Novas posições (médias ponderadas) em destino a partir das somas da passada; clusters vazios
+// mantêm a posição atual. Retorna o maior deslocamento de uma coordenada.
+static double calcularNovasPosicoes(const vector<double>& atual, vector<double>& destino, const Atribuicao& atribuicao, size_t K, size_t d) {
+    double deslocamento = 0.0;
+    for (size_t k = 0; k < K; ++k) {
+        bool vazio = atribuicao.contagens[k] == 0 || atribuicao.massas[k] <= 0.0;
+        for (size_t j = 0; j < d; ++j) {
+            size_t posicao = k * d + j;
+            destino[posicao] = vazio ? atual[posicao] : atribuicao.somas[posicao] / atribuicao.massas[k];
+            deslocamento = max(deslocamento, fabs(destino[posicao] - atual[posicao]));
+        }
+    }
+    return deslocamento;
+}
+
+// Laço de Lloyd com dois buffers de posições alternados por ponteiro: não há cópia dos centroides
+// nem das listas de instâncias próximas entre iterações, e mudanças de rótulo, inércia e
+// deslocamento saem da própria passada. Retorna o número de iterações após a passada inicial.
+int executarLloyd(vector<Centroide>& centroides, vector<Instancia>& instancias, DadosAtribuicao& dados, Atribuicao& atribuicao, uint64_t semente, PoliticaVazio politica, const CriterioParada& parada, const ConfiguracaoPontoDeControle& pontoDeControle, PontoDeControle* retomada) {
+    const size_t K = centroides.size();
+    const size_t d = dados.getDimensao();
+    const size_t n = dados.getNumInstancias();
+
+    vector<double> bufferA(K * d), bufferB(K * d);
+    vector<double>* atual = &bufferA;
+    vector<double>* proximo = &bufferB;
+
+    auto publicar = [&]() {
+        for (size_t k = 0; k < K; ++k) {
+            centroides[k].setAtributos(atual->data() + k * d, d);
+        }
+    };
+
+    double inerciaAnterior = -1.0;
+    int iteracao = 0;
+
+    // Na retomada, o estado salvo substitui a passada inicial e as iterações já feitas
+    if (retomada) {
+        PontoDeControle& salvo = *retomada;
+        if (salvo.numCentroides != K || salvo.dimensao != d || salvo.numInstancias != n || salvo.semente != semente) {
+            throw invalid_argument("O ponto de controle nao corresponde a esta execucao: " + pontoDeControle.caminho);
+        }
+        *atual = move(salvo.posicoes);
+        publicar();
+        atribuicao.rotulos.assign(salvo.rotulos.begin(), salvo.rotulos.end());
+        atribuicao.distancias = move(salvo.distancias);
+        atribuicao.somas = move(salvo.somas);
+        atribuicao.massas = move(salvo.massas);
+        atribuicao.contagens.assign(salvo.contagens.begin(), salvo.contagens.end());
+        iteracao = salvo.iteracao;
+        inerciaAnterior = salvo.inerciaAnterior;
+    } else {
+        // A passada inicial trata os centroides vazios conforme a política (estado 1)
+        calcularCentroidesProximos(centroides, instancias, dados, atribuicao, 1, semente, politica);
+        for (auto& centroide : centroides) {
+            centroide.limparInstanciasProximas();
+        }
+
+        for (size_t k = 0; k < K; ++k) {
+            const vector<double> atributos = centroides[k].getAtributos();
+            copy(atributos.begin(), atributos.end(), atual->begin() + k * d);
+        }
+
+        calcularNovasPosicoes(*atual, *proximo, atribuicao, K, d);
+        swap(atual, proximo);
+        publicar();
+    }
+
+    unique_ptr<GravadorPontoDeControle> gravador;
+    if (!pontoDeControle.caminho.empty() && pontoDeControle.intervalo > 0) {
+        gravador = make_unique<GravadorPontoDeControle>(pontoDeControle.caminho);
+    }
+
+    // Com rastreamento ativo cada iteração registra o tempo das fases e os contadores da passada
+    Rastreamento* rastreamento = Rastreamento::ativo() ? Rastreamento::getAtual() : nullptr;
+    IteracaoLloyd registro;
+    if (rastreamento) {
+        registro.chamada = rastreamento->novaChamada();
+    }
+    double marca = 0.0;
+    int64_t bytesInicio = 0;
+    auto medirFase = [&](double& tempo) {
+        double agora = Rastreamento::agora();
+        tempo = agora - marca;
+        marca = agora;
+    };
+
+    // Modo de perfil: contadores de hardware por fase, acumulados ao longo das iterações
+    PerfilHardware* perfil = PerfilHardware::getAtual();
+    if (perfil && !perfil->estaDisponivel()) {
+        perfil = nullptr;
+    }
+
+    bool convergiu = false;
+    while (!convergiu) {
+        if (rastreamento) {
+            marca = registro.inicio = Rastreamento::agora();
+            bytesInicio = Rastreamento::bytesAlocados();
+        }
+
+        if (perfil) perfil->marcar();
+        dados.atribuir(centroides, atribuicao);
+        ++iteracao;
+        if (perfil) perfil->registrar("atribuicao");
+        if (rastreamento) medirFase(registro.tempoAtribuicao);
+
+        // O reparo local é barato o suficiente para rodar em todas as passadas, cada uma com a sua semente
+        if (politica != VAZIO_REINICIAR) {
+            uint64_t sementePassada = GeradorAleatorio::gerar(semente, FLUXO_VAZIO, iteracao);
+            repararClustersVazios(centroides, instancias, atribuicao, politica, sementePassada, 0);
+            if (rastreamento) medirFase(registro.tempoReparo);
+        }
+
+        double deslocamento = calcularNovasPosicoes(*atual, *proximo, atribuicao, K, d);
+        swap(atual, proximo);
+        publicar();
+        if (perfil) perfil->registrar("atualizacao");
+        if (rastreamento) medirFase(registro.tempoAtualizacao);
+
+        convergiu = deslocamento <= parada.toleranciaDeslocamento
+                 || (parada.fracaoMudancas > 0.0 && atribuicao.mudancas <= parada.fracaoMudancas * n)
+                 || (parada.melhoraInercia > 0.0 && inerciaAnterior >= 0.0 &&
+                     inerciaAnterior - atribuicao.inercia <= parada.melhoraInercia * inerciaAnterior)
+                 || (parada.maxIteracoes > 0 && iteracao >= parada.maxIteracoes);
+        inerciaAnterior = atribuicao.inercia;
+
+        // Cópia do estado para a thread de gravação; o laço não espera pelo disco
+        if (gravador && !convergiu && iteracao % pontoDeControle.intervalo == 0) {
+            PontoDeControle estado;
+            estado.semente = semente;
+            estado.iteracao = iteracao;
+            estado.numCentroides = K;
+            estado.dimensao = d;
+            estado.numInstancias = n;
+            estado.inerciaAnterior = inerciaAnterior;
+            estado.posicoes = *atual;
+            estado.somas = atribuicao.somas;
+            estado.massas = atribuicao.massas;
+            estado.contagens.assign(atribuicao.contagens.begin(), atribuicao.contagens.end());
+            estado.rotulos.assign(atribuicao.rotulos.begin(), atribuicao.rotulos.end());
+            if (pontoDeControle.incluirDistancias) {
+                estado.distancias = atribuicao.distancias;
+            }
+            gravador->gravar(move(estado));
+        }
+
+        if (rastreamento) {
+            medirFase(registro.tempoConvergencia);
+            registro.iteracao = iteracao;
+            registro.inercia = atribuicao.inercia;
+            registro.mudancas = atribuicao.mudancas;
+            registro.distanciasCalculadas = atribuicao.distanciasCalculadas;
+            registro.distanciasEvitadas = atribuicao.distanciasEvitadas;
+            registro.bytesAlocados = Rastreamento::bytesAlocados() - bytesInicio;
+            rastreamento->registrarIteracao(registro);
+        }
+    }
+
+    return iteracao;
 }
 
 map<int, int> mapearMatrizEsperada(const vector<Centroide>& centroides, int baseDados) {
@@ -324,36 +559,315 @@ map<int,int> mapearMatrizReal(const vector<Centroide>& centroides, int baseDados
     return resultado;
 }
 
+// CSR quando a configuração pede o modo esparso; caso contrário, base densa particionada entre os nós NUMA
+unique_ptr<DadosAtribuicao> criarDadosAtribuicao(const vector<Instancia>& instancias, const ConfiguracaoKmeans& configuracao){
+    if (configuracao.esparso) {
+        return make_unique<DadosEsparsos>(DadosEsparsos::deInstancias(instancias));
+    }
+    if (configuracao.bitsQuantizacao > 0) {
+        return make_unique<DadosQuantizados>(instancias, configuracao.bitsQuantizacao);
+    }
+    return make_unique<DadosNuma>(instancias, TopologiaNuma::detectar(), configuracao.threadsAtribuicao);
+}
+
+// Substitui os atributos de cada centroide pela média ponderada, nos atributos de "originais", das
+// instâncias próximas a ele (identificadas pelo id)
+void elevarCentroides(vector<Centroide>& centroides, const vector<Instancia>& originais){
+    unordered_map<int, size_t> posicoes;
+    for(size_t i = 0; i < originais.size(); i++){
+        posicoes[originais[i].getId()] = i;
+    }
+
+    size_t d = originais[0].getAtributos().size();
+    for(Centroide& centroide : centroides){
+        vector<double> media(d, 0.0);
+        double massa = 0.0;
+        for(const Instancia& instancia : centroide.getProximos()){
+            const Instancia& original = originais[posicoes.at(instancia.getId())];
+            const vector<double> atributos = original.getAtributos();
+            for(size_t j = 0; j < d; j++){
+                media[j] += original.getPeso() * atributos[j];
+            }
+            massa += original.getPeso();
+        }
+        if(massa > 0.0){
+            for(double& valor : media){
+                valor /= massa;
+            }
+        }
+        centroide.setAtributos(media);
+        centroide.limparInstanciasProximas();
+    }
+}
+
 void kmeans(int baseDeDados, int K){
+    kmeans(baseDeDados, K, ConfiguracaoKmeans());
+}
+
+// Execução sobre o arquivo SVMlight de configuracao.caminhoBaseEsparsa: o Lloyd roda no kernel CSR
+// e os centroides são as únicas estruturas densas, então a memória acompanha o número de não nulos
+static void kmeansBaseEsparsa(int K, const ConfiguracaoKmeans& configuracao, uint64_t semente, PontoDeControle* retomada,
+                              vector<string> observacoes, chrono::high_resolution_clock::time_point start) {
+    if (configuracao.tamanhoCoreset > 0 || configuracao.dimensaoReduzida > 0 || configuracao.hierarquico ||
+        !configuracao.caminhoModeloAnterior.empty()) {
+        throw invalid_argument("A base esparsa em arquivo nao pode ser combinada com coreset, reducao de dimensionalidade, modo hierarquico ou warm start.");
+    }
+
+    Rastreamento* rastreamento = Rastreamento::ativo() ? Rastreamento::getAtual() : nullptr;
+    double inicioFase = Rastreamento::agora();
+
+    DadosEsparsos dados = DadosEsparsos::lerSvmLight(configuracao.caminhoBaseEsparsa);
+    const size_t n = dados.getNumInstancias();
+    if (n < (size_t) K) {
+        throw invalid_argument("A base tem menos instancias que K.");
+    }
+
+    auto endInstancias = chrono::high_resolution_clock::now();
+    if (rastreamento) {
+        double agora = Rastreamento::agora();
+        rastreamento->registrarFase("leitura", inicioFase, agora - inicioFase);
+        inicioFase = agora;
+    }
+
+    ostringstream oss;
+    oss << "Base esparsa: " << n << " instancias, " << dados.getDimensao() << " atributos, " << dados.getNumNaoNulos() << " nao nulos";
+    observacoes.push_back(oss.str());
+
+    // Forgy nas linhas amostradas: o sorteio na faixa de cada atributo pediria as estatísticas densas
+    vector<size_t> amostra = amostrarInstancias(n, K, semente);
+    vector<Centroide> centroides;
+    for (size_t k = 0; k < amostra.size(); ++k) {
+        centroides.emplace_back(k, dados.getLinhaDensa(amostra[k]), vector<Instancia>());
+    }
+
+    vector<Instancia> semInstancias;
+    Atribuicao atribuicao;
+    int iteracoes = executarLloyd(centroides, semInstancias, dados, atribuicao, semente, configuracao.politicaVazio, configuracao.parada, configuracao.pontoDeControle, retomada);
+    dados.atribuir(centroides, atribuicao);
+    observacoes.push_back("Iteracoes do Lloyd: " + to_string(iteracoes));
+    observacoes.push_back("Inercia: " + to_string(atribuicao.inercia));
+    observacoes.push_back("Metricas nao calculadas: a base esparsa nao tem as instancias densas");
+
+    auto end = chrono::high_resolution_clock::now();
+    vector<chrono::milliseconds> durations;
+    durations.push_back(chrono::duration_cast<chrono::milliseconds>(end - start));
+    durations.push_back(chrono::duration_cast<chrono::milliseconds>(endInstancias - start));
+    durations.push_back(chrono::duration_cast<chrono::milliseconds>(end - endInstancias));
+    if (rastreamento) {
+        rastreamento->registrarFase("treino", inicioFase, Rastreamento::agora() - inicioFase);
+    }
+
+    if (!configuracao.prefixoResultados.empty()) {
+        EscritorResultados resultados(configuracao.prefixoResultados);
+        resultados.escreverParticao(centroides, dados.getIds(), atribuicao.rotulos);
+        resultados.escreverIndices({"inercia"}, {atribuicao.inercia});
+        resultados.fechar();
+    }
+
+    vector<double> indices(5, numeric_limits<double>::quiet_NaN());
+    Centroide::escreverCentroidesComInstancias(centroides, durations, indices, observacoes);
+
+    if (!configuracao.caminhoModelo.empty()) {
+        Modelo modelo(centroides, n, atribuicao.inercia);
+        modelo.salvar(configuracao.caminhoModelo);
+    }
+}
+
+void kmeans(int baseDeDados, int K, const ConfiguracaoKmeans& configuracao){
 
     auto start = chrono::high_resolution_clock::now();
 
-    vector<Instancia> instancias;
-    if(baseDeDados == 1){
-        instancias = Instancia::lerIris();
-    } else if (baseDeDados == 2){
-        instancias = Instancia::lerMFeat();
-    } else{
+    unique_ptr<Rastreamento> rastreamento;
+    if (!configuracao.caminhoRastreamento.empty()) {
+        rastreamento = make_unique<Rastreamento>(configuracao.caminhoRastreamento, configuracao.formatoRastreamento);
+    }
+    double inicioFase = Rastreamento::agora();
+    unique_ptr<PerfilHardware> perfil;
+    if (configuracao.contadoresHardware) {
+        perfil = make_unique<PerfilHardware>();
+    }
+
+    if (configuracao.caminhoBaseEsparsa.empty() && baseDeDados != 1 && baseDeDados != 2) {
         cout << "Opção inválida!" << endl;
         cout << "Finalizando Programa." << endl;
         return;
     }
 
+    // Todos os sorteios derivam desta semente; com ela fixada, a execução é reproduzível
+    // independentemente do número de threads
+    uint64_t semente = configuracao.semente != 0 ? configuracao.semente : GeradorAleatorio::sementeAleatoria();
+
+    // Na retomada, a semente é a do ponto de controle, para que coreset, projeção e sorteios se repitam
+    const ConfiguracaoPontoDeControle& pontoDeControle = configuracao.pontoDeControle;
+    PontoDeControle salvo;
+    bool retomar = pontoDeControle.retomar && !pontoDeControle.caminho.empty() &&
+                   PontoDeControle::carregar(pontoDeControle.caminho, salvo);
+    if (retomar) {
+        if (configuracao.semente != 0 && configuracao.semente != salvo.semente) {
+            throw invalid_argument("A semente configurada difere da semente do ponto de controle.");
+        }
+        semente = salvo.semente;
+    }
+
+    vector<string> observacoes;
+    observacoes.push_back("Semente: " + to_string(semente));
+    if (retomar) {
+        observacoes.push_back("Retomado do ponto de controle da iteracao " + to_string(salvo.iteracao));
+    }
+
+    if (!configuracao.caminhoBaseEsparsa.empty()) {
+        kmeansBaseEsparsa(K, configuracao, semente, retomar ? &salvo : nullptr, observacoes, start);
+        return;
+    }
+
+    // A semente vem antes da leitura: o reservatório da inicialização é amostrado enquanto a base é
+    // convertida, junto com as estatísticas dos atributos usadas no sorteio dos centroides
+    size_t tamanhoAmostra = configuracao.inicializacaoAmostra ? K : 0;
+    BaseCarregada base = baseDeDados == 1 ? carregarIris(tamanhoAmostra, semente) : carregarMFeat(tamanhoAmostra, semente);
+    vector<Instancia> instancias = move(base.instancias);
 
     auto endInstancias = chrono::high_resolution_clock::now();
+    if (rastreamento) {
+        double agora = Rastreamento::agora();
+        rastreamento->registrarFase("leitura", inicioFase, agora - inicioFase);
+        inicioFase = agora;
+    }
 
-    vector<Centroide> centroides = criarCentroidesAleatorios(K, instancias);
-    vector<Centroide> centroidesAntigo;
-    
-    calcularCentroidesProximos(centroides, instancias, 1);
-    atualizarCentroides(centroides);
+    bool warmStart = !configuracao.caminhoModeloAnterior.empty();
+    if (warmStart && (configuracao.tamanhoCoreset > 0 || configuracao.dimensaoReduzida > 0 || configuracao.hierarquico)) {
+        throw invalid_argument("O warm start nao pode ser combinado com coreset, reducao de dimensionalidade ou modo hierarquico.");
+    }
+
+    // Com coreset, o laço de Lloyd roda sobre a amostra ponderada em vez da base inteira
+    vector<Instancia> coreset;
+    if (configuracao.tamanhoCoreset > 0) {
+        coreset = construirCoreset(instancias, configuracao.tamanhoCoreset, semente);
+    }
+    vector<Instancia>& amostra = coreset.empty() ? instancias : coreset;
+
+    // Redução de dimensionalidade opcional: o treino roda no espaço reduzido
+    Projecao projecao;
+    vector<Instancia> amostraReduzida;
+    size_t dimensao = amostra[0].getAtributos().size();
+    bool reduzir = configuracao.dimensaoReduzida > 0 && configuracao.dimensaoReduzida < dimensao;
+    if (reduzir) {
+        projecao = configuracao.reducaoPca ? Projecao::pca(amostra, configuracao.dimensaoReduzida, semente)
+                                           : Projecao::aleatoria(dimensao, configuracao.dimensaoReduzida, semente);
+        amostraReduzida = projecao.aplicar(amostra);
+
+        Projecao::Distorcao distorcao = projecao.medirDistorcao(amostra, amostraReduzida, semente);
+        ostringstream oss;
+        oss << "Reducao de dimensionalidade (" << (configuracao.reducaoPca ? "PCA" : "projecao aleatoria") << "): "
+            << dimensao << " -> " << projecao.getDimReduzida() << " atributos. Distorcao media: " << distorcao.media
+            << ", maxima: " << distorcao.maxima;
+        if (projecao.getVarianciaRetida() >= 0.0) {
+            oss << ", variancia retida: " << projecao.getVarianciaRetida();
+        }
+        observacoes.push_back(oss.str());
+    }
+    vector<Instancia>& treino = reduzir ? amostraReduzida : amostra;
+
+    // No warm start, as instâncias além das usadas no treino anterior são as novas
+    Modelo anterior;
+    vector<Instancia> novas;
+    if (warmStart) {
+        anterior = Modelo::carregar(configuracao.caminhoModeloAnterior);
+        size_t numHistorico = anterior.getNumInstanciasTreino();
+        if (anterior.getNumCentroides() != (size_t) K || numHistorico > instancias.size()) {
+            throw invalid_argument("O modelo anterior nao corresponde a esta base de dados ou a este K.");
+        }
+        novas.assign(instancias.begin() + numHistorico, instancias.end());
+    }
+    // Sem avaliacaoCompletaWarmStart, o relatório do warm start cobre só as novas instâncias, para
+    // que o custo continue proporcional a elas
+    bool avaliarNovas = warmStart && !configuracao.avaliacaoCompletaWarmStart && !novas.empty();
+
+    // Passada exata opcional sobre a base completa com os centroides do coreset, no espaço
+    // original ou, se pedido, no espaço reduzido
+    bool atribuicaoCompleta = &amostra == &instancias || configuracao.atribuicaoFinalCompleta;
+    bool espacoOriginal = !reduzir || configuracao.atribuicaoFinalOriginal;
+    // O modelo não guarda a projeção, então centroides no espaço reduzido não serviriam para predizer
+    // nem para o warm start sobre as instâncias originais
+    if (!espacoOriginal && !configuracao.caminhoModelo.empty()) {
+        throw invalid_argument("O modelo so pode ser salvo com a atribuicao final no espaco original (atribuicaoFinalOriginal).");
+    }
+    vector<Instancia>& avaliadasOriginais = avaliarNovas ? novas : atribuicaoCompleta ? instancias : amostra;
+    vector<Instancia> avaliadasReduzidas;
+    if (!espacoOriginal) {
+        avaliadasReduzidas = &avaliadasOriginais == &amostra ? amostraReduzida : projecao.aplicar(avaliadasOriginais);
+    }
+    vector<Instancia>& avaliadas = espacoOriginal ? avaliadasOriginais : avaliadasReduzidas;
+    vector<Centroide> centroides;
+
+    // Os backends pedidos explicitamente têm precedência sobre o seletor
+    ConfiguracaoKmeans ajustada = configuracao;
+    if (configuracao.selecaoAutomatica && !configuracao.hierarquico && !configuracao.esparso && configuracao.bitsQuantizacao == 0) {
+        SeletorBackend seletor(configuracao.caminhoPerfilMaquina, configuracao.calibrarSelecao);
+        EscolhaBackend escolha = seletor.escolher(treino, K, semente);
+        escolha.aplicar(ajustada);
+        observacoes.push_back(escolha.descrever());
+    }
+
+    if (warmStart) {
+        // Só as instâncias acrescentadas depois do treino anterior são atribuídas
+        vector<Instancia> historico;
+        if (configuracao.reatribuirHistorico) {
+            historico.assign(instancias.begin(), instancias.end() - novas.size());
+        }
+        Modelo::ResultadoAtualizacao resultado = anterior.atualizar(novas, historico, configuracao.iteracoesIncrementais);
+        centroides = anterior.getCentroidesComoObjetos();
+
+        ostringstream oss;
+        oss << "Warm start: " << novas.size() << " novas instancias, " << resultado.iteracoes << " iteracoes, "
+            << resultado.mudancas << " mudancas de cluster, " << resultado.distanciasEvitadas << " distancias evitadas";
+        observacoes.push_back(oss.str());
+
+        unique_ptr<DadosAtribuicao> dados = criarDadosAtribuicao(avaliadas, ajustada);
+        Atribuicao atribuicao;
+        calcularCentroidesProximos(centroides, avaliadas, *dados, atribuicao, 0);
+    } else if (configuracao.hierarquico) {
+        ArvoreKmeans arvore = ArvoreKmeans::construir(treino, K, configuracao.ramificacao, semente);
+        centroides = arvore.getCentroides();
+
+        // A própria hierarquia serve de índice para a atribuição final
+        arvore.atribuirInstancias(centroides, reduzir && espacoOriginal ? treino : avaliadas);
+    } else {
+        unique_ptr<DadosAtribuicao> dados = criarDadosAtribuicao(treino, ajustada);
+        Atribuicao atribuicao;
+
+        // Sobre a base inteira, a inicialização usa o que a leitura já calculou
+        if (configuracao.inicializacaoAmostra) {
+            vector<size_t> indices = &treino == &instancias ? base.amostra : amostrarInstancias(treino.size(), K, semente);
+            if (indices.size() < (size_t) K) {
+                throw invalid_argument("A base tem menos instancias que K.");
+            }
+            centroides = criarCentroidesDaAmostra(treino, indices);
+        } else if (&treino == &instancias) {
+            centroides = criarCentroidesAleatorios(K, base.estatisticas, semente);
+        } else {
+            centroides = criarCentroidesAleatorios(K, treino, semente);
+        }
+        int iteracoes = executarLloyd(centroides, treino, *dados, atribuicao, semente, configuracao.politicaVazio, configuracao.parada, pontoDeControle, retomar ? &salvo : nullptr);
+        observacoes.push_back("Iteracoes do Lloyd: " + to_string(iteracoes));
+
+        if (reduzir && espacoOriginal) {
+            calcularCentroidesProximos(centroides, treino, *dados, atribuicao, 0);
+        } else {
+            if (&avaliadas != &treino) {
+                dados = criarDadosAtribuicao(avaliadas, ajustada);
+            }
+            calcularCentroidesProximos(centroides, avaliadas, *dados, atribuicao, 0);
+        }
+    }
 
-    do{
-        centroidesAntigo = centroides;
-        calcularCentroidesProximos(centroides, instancias, 0);
-        atualizarCentroides(centroides);
-    }while(!verificarConvergencia(centroides, centroidesAntigo, 0.001));
-        calcularCentroidesProximos(centroides,instancias, 0);
+    if (reduzir && espacoOriginal) {
+        // Leva os centroides ao espaço original como a média dos membros de cada cluster e faz uma
+        // única passada de atribuição sobre os atributos originais
+        elevarCentroides(centroides, amostra);
+        unique_ptr<DadosAtribuicao> dados = criarDadosAtribuicao(avaliadas, ajustada);
+        Atribuicao atribuicao;
+        calcularCentroidesProximos(centroides, avaliadas, *dados, atribuicao, 0);
+    }
 
 
     auto end = chrono::high_resolution_clock::now();
@@ -366,11 +880,25 @@ void kmeans(int baseDeDados, int K){
     durations.push_back(durationInstancias);
     durations.push_back(durationCentroides);
 
+    if (rastreamento) {
+        double agora = Rastreamento::agora();
+        rastreamento->registrarFase("treino", inicioFase, agora - inicioFase);
+        inicioFase = agora;
+    }
+
+    // A partição já está pronta: a escrita dos rótulos corre enquanto as métricas são calculadas
+    unique_ptr<EscritorResultados> resultados;
+    if (!configuracao.prefixoResultados.empty()) {
+        resultados = make_unique<EscritorResultados>(configuracao.prefixoResultados);
+        resultados->escreverParticao(centroides);
+    }
+
+    if (perfil) perfil->marcar();
     double silhouette = silhouetteMeasure(centroides);
-    double medidaF = fmeasure(centroides, baseDeDados, instancias);
+    double medidaF = fmeasure(centroides, baseDeDados, avaliadas);
     double davies = daviesBouldin(centroides);
-    double calinski = calinskiHarabasz(centroides, instancias);
-    double ari = adjustedRandIndex(centroides, baseDeDados, instancias);
+    double calinski = calinskiHarabasz(centroides, avaliadas);
+    double ari = adjustedRandIndex(centroides, baseDeDados, avaliadas);
 
     vector<double> indices;
     indices.push_back(move(silhouette));
@@ -378,29 +906,62 @@ void kmeans(int baseDeDados, int K){
     indices.push_back(move(davies));
     indices.push_back(move(calinski));
     indices.push_back(move(ari));
+    if (perfil) {
+        perfil->registrar("metricas");
+        vector<string> linhas = perfil->relatorio();
+        observacoes.insert(observacoes.end(), linhas.begin(), linhas.end());
+    }
+    if (rastreamento) {
+        rastreamento->registrarFase("avaliacao", inicioFase, Rastreamento::agora() - inicioFase);
+    }
+
+    if (resultados) {
+        resultados->escreverIndices({"silhouette", "f_measure", "davies_bouldin", "calinski_harabasz", "adjusted_rand_index"}, indices);
+        resultados->fechar();
+    }
 
-    Centroide::escreverCentroidesComInstancias(centroides, durations, indices);
+    Centroide::escreverCentroidesComInstancias(centroides, durations, indices, observacoes);
+
+    if (!configuracao.caminhoModelo.empty()) {
+        // O modelo atualizado já traz as estatísticas e a inércia de toda a base
+        if (warmStart) {
+            anterior.salvar(configuracao.caminhoModelo);
+        } else {
+            // O número de linhas é o da base, mesmo quando só o coreset foi atribuído: é ele que
+            // separa o histórico das novas instâncias num warm start
+            Modelo modelo(centroides, instancias.size(), calcularInercia(centroides));
+            modelo.salvar(configuracao.caminhoModelo);
+        }
+    }
 }
 
 double fmeasure(vector<Centroide>& centroides, int baseDados,const vector<Instancia>& instancias){
     map<int,int> matrizEsperada = mapearMatrizEsperada(centroides, baseDados);
     map<int,int> matrizReal = mapearMatrizReal(centroides, baseDados);
 
-    int TP = 0;
-    int FP = 0;
-    int FN = 0;
+    // Cada instância conta com o seu peso; instâncias fora da amostra avaliada são ignoradas
+    map<int,double> pesos;
+    for(const Instancia& instancia : instancias){
+        pesos[instancia.getId()] = instancia.getPeso();
+    }
+
+    double TP = 0;
+    double FP = 0;
+    double FN = 0;
 
     for(const auto& par : matrizEsperada){
         int id = par.first;
         int classEsperada = par.second;
-        int classReal = matrizReal[id];
-    
+        auto real = matrizReal.find(id);
+        if(real == matrizReal.end()) continue;
+        int classReal = real->second;
+        double peso = pesos.count(id) ? pesos[id] : 1.0;
 
         if(classReal == classEsperada){
-            TP++;
+            TP += peso;
         } else{
-            FP++;
-            FN++;
+            FP += peso;
+            FN += peso;
         }
     }
 
@@ -436,6 +997,7 @@ vector<vector<int>> calcularMatrizDeContingencia(const map<int, int>& esperado,
     for (const auto& par : esperado) {
         int index = par.first;
         int verdadeiroCluster = par.second;
+        if (real.find(index) == real.end()) continue;
         int preditoCluster = real.at(index);
         matrizDeContingencia[verdadeiroCluster][preditoCluster]++;
     }
@@ -449,7 +1011,11 @@ double adjustedRandIndex(const vector<Centroide>& centroides, int baseDados, con
 
     vector<vector<int>> matrizContingencia = calcularMatrizDeContingencia(mapaEsperado, mapaReal, baseDados);
     
-    int numInstancias = instancias.size();
+    // Conta apenas as instâncias presentes na matriz (a amostra, quando a base não é toda atribuída)
+    int numInstancias = 0;
+    for(const auto& linha : matrizContingencia){
+        numInstancias = accumulate(linha.begin(), linha.end(), numInstancias);
+    }
     int numClasses;
     if(baseDados == 1){
         numClasses = 3;
@@ -501,13 +1067,26 @@ void imprimirMap(const map<int, int>& mapa) {
 }
 
 double distanciaIntraClusterDaviesBouldin(Centroide centroide){
-    double distancia;
+    double distancia = 0.0;
+    double massa = 0.0;
     vector<Instancia> instancias = centroide.getProximos();
     for(Instancia instancia : instancias){
-        distancia += calcularDistanciaEuclidiana(instancia.getAtributos(), centroide.getAtributos());
+        distancia += instancia.getPeso() * calcularDistanciaEuclidiana(instancia.getAtributos(), centroide.getAtributos());
+        massa += instancia.getPeso();
     }
 
-    return distancia / (instancias.size());
+    return distancia / massa;
+}
+
+double calcularInercia(const vector<Centroide>& centroides){
+    double inercia = 0.0;
+    for(const Centroide& centroide : centroides){
+        const vector<double> atributosCentroide = centroide.getAtributos();
+        for(const Instancia& instancia : centroide.getProximos()){
+            inercia += instancia.getPeso() * pow(calcularDistanciaEuclidiana(instancia.getAtributos(), atributosCentroide), 2);
+        }
+    }
+    return inercia;
 }
 
 double daviesBouldin(const vector<Centroide>& centroides) {
@@ -548,14 +1127,16 @@ double daviesBouldin(const vector<Centroide>& centroides) {
 
 vector<double> calcularCentroideGlobal(const vector<Instancia>& instancias){
     vector<double> global(instancias[0].getAtributos().size(), 0.0);
+    double massa = 0.0;
     for(const Instancia instancia : instancias){
         const vector<double> atributos = instancia.getAtributos();
         for(int i = 0; i < atributos.size(); i++){
-            global[i] += atributos[i];
+            global[i] += instancia.getPeso() * atributos[i];
         }
+        massa += instancia.getPeso();
     }
     for(double& valor : global){
-        valor = valor / instancias.size();
+        valor = valor / massa;
     }
     return global;
 }
@@ -565,17 +1146,21 @@ double calinskiHarabasz(vector<Centroide> centroides, vector<Instancia> instanci
 
     double B = 0.0;
     double W = 0.0;
+    double massaTotal = 0.0;
 
     for(Centroide cen : centroides){
-        double distanciaCentroide = calcularDistanciaEuclidiana(cen.getAtributos(), global);
-        B += pow(distanciaCentroide,2) * cen.getProximos().size();
-
         vector<Instancia> insCentroides = cen.getProximos();
 
+        double massa = 0.0;
         for(Instancia& ins : insCentroides){
-            W += pow(calcularDistanciaEuclidiana(ins.getAtributos(), cen.getAtributos()), 2);
+            W += ins.getPeso() * pow(calcularDistanciaEuclidiana(ins.getAtributos(), cen.getAtributos()), 2);
+            massa += ins.getPeso();
         }
+
+        double distanciaCentroide = calcularDistanciaEuclidiana(cen.getAtributos(), global);
+        B += pow(distanciaCentroide,2) * massa;
+        massaTotal += massa;
     }
 
-    return (B/(centroides.size()-1)) / (W/(instancias.size()-centroides.size()));
+    return (B/(centroides.size()-1)) / (W/(massaTotal-centroides.size()));
 }
@@ -0,0 +1,535 @@
+#include "Library/modelo.h"
+#include <fstream>
+#include <future>
+#include <thread>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+using namespace std;
+
+static const char MAGICO[4] = {'K', 'M', 'D', 'L'};
+static const uint32_t VERSAO_MODELO = 2;
+
+// Construtores
+Modelo::Modelo(const vector<Centroide>& centroides, uint64_t numInstanciasTreino, double inercia)
+    : numCentroides(centroides.size()), dimensao(0), numInstanciasTreino(numInstanciasTreino), inercia(inercia) {
+    if (centroides.empty()) {
+        throw invalid_argument("O modelo precisa de pelo menos um centroide.");
+    }
+    dimensao = centroides[0].getAtributos().size();
+
+    this->centroides.reserve(numCentroides * dimensao);
+    somas.assign(numCentroides * dimensao, 0.0);
+    massas.assign(numCentroides, 0.0);
+    contagens.assign(numCentroides, 0);
+    somasQuadrados.assign(numCentroides, 0.0);
+    for (size_t k = 0; k < numCentroides; ++k) {
+        const vector<double> atributos = centroides[k].getAtributos();
+        double norma = 0.0;
+        for (double valor : atributos) {
+            norma += valor * valor;
+        }
+        this->centroides.insert(this->centroides.end(), atributos.begin(), atributos.end());
+        normas.push_back(norma);
+
+        for (const Instancia& instancia : centroides[k].getProximos()) {
+            const vector<double> valores = instancia.getAtributos();
+            double peso = instancia.getPeso();
+            for (size_t j = 0; j < dimensao; ++j) {
+                somas[k * dimensao + j] += peso * valores[j];
+                somasQuadrados[k] += peso * valores[j] * valores[j];
+            }
+            massas[k] += peso;
+            contagens[k]++;
+        }
+    }
+
+    dataTreino = chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Getters
+size_t Modelo::getNumCentroides() const {
+    return numCentroides;
+}
+
+size_t Modelo::getDimensao() const {
+    return dimensao;
+}
+
+const vector<double>& Modelo::getCentroides() const {
+    return centroides;
+}
+
+const vector<double>& Modelo::getNormas() const {
+    return normas;
+}
+
+uint64_t Modelo::getNumInstanciasTreino() const {
+    return numInstanciasTreino;
+}
+
+double Modelo::getInercia() const {
+    return inercia;
+}
+
+int64_t Modelo::getDataTreino() const {
+    return dataTreino;
+}
+
+bool Modelo::temEstatisticas() const {
+    for (double massa : massas) {
+        if (massa > 0.0) return true;
+    }
+    return false;
+}
+
+const vector<double>& Modelo::getMassas() const {
+    return massas;
+}
+
+vector<Centroide> Modelo::getCentroidesComoObjetos() const {
+    vector<Centroide> resultado;
+    for (size_t k = 0; k < numCentroides; ++k) {
+        vector<double> atributos(centroides.begin() + k * dimensao, centroides.begin() + (k + 1) * dimensao);
+        resultado.push_back(Centroide(k, atributos, {}));
+    }
+    return resultado;
+}
+
+template <typename T>
+void escreverValor(ofstream& arquivo, const T& valor) {
+    arquivo.write(reinterpret_cast<const char*>(&valor), sizeof(T));
+}
+
+template <typename T>
+void lerValor(ifstream& arquivo, T& valor) {
+    arquivo.read(reinterpret_cast<char*>(&valor), sizeof(T));
+}
+
+bool Modelo::salvar(const string& caminho, TipoDados tipo) const {
+    ofstream arquivo(caminho, ios::binary);
+
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir o arquivo para escrita: " << caminho << endl;
+        return false;
+    }
+
+    arquivo.write(MAGICO, sizeof(MAGICO));
+    escreverValor(arquivo, VERSAO_MODELO);
+    escreverValor(arquivo, static_cast<uint32_t>(tipo));
+    escreverValor(arquivo, static_cast<uint64_t>(numCentroides));
+    escreverValor(arquivo, static_cast<uint64_t>(dimensao));
+    escreverValor(arquivo, numInstanciasTreino);
+    escreverValor(arquivo, inercia);
+    escreverValor(arquivo, dataTreino);
+
+    if (tipo == FLOAT32) {
+        // As normas gravadas são as dos centroides arredondados, que são os que o modelo carregado usa
+        vector<float> reduzidos(centroides.begin(), centroides.end());
+        vector<double> normasReduzidas(numCentroides, 0.0);
+        for (size_t k = 0; k < numCentroides; ++k) {
+            for (size_t j = 0; j < dimensao; ++j) {
+                double valor = reduzidos[k * dimensao + j];
+                normasReduzidas[k] += valor * valor;
+            }
+        }
+        arquivo.write(reinterpret_cast<const char*>(reduzidos.data()), reduzidos.size() * sizeof(float));
+        arquivo.write(reinterpret_cast<const char*>(normasReduzidas.data()), normasReduzidas.size() * sizeof(double));
+    } else {
+        arquivo.write(reinterpret_cast<const char*>(centroides.data()), centroides.size() * sizeof(double));
+        arquivo.write(reinterpret_cast<const char*>(normas.data()), normas.size() * sizeof(double));
+    }
+
+    // Versão 2: estatísticas suficientes dos clusters, sempre em double
+    arquivo.write(reinterpret_cast<const char*>(somas.data()), somas.size() * sizeof(double));
+    arquivo.write(reinterpret_cast<const char*>(massas.data()), massas.size() * sizeof(double));
+    arquivo.write(reinterpret_cast<const char*>(contagens.data()), contagens.size() * sizeof(uint64_t));
+    arquivo.write(reinterpret_cast<const char*>(somasQuadrados.data()), somasQuadrados.size() * sizeof(double));
+
+    arquivo.close();
+    if (!arquivo) {
+        cerr << "Erro ao gravar o modelo: " << caminho << endl;
+        return false;
+    }
+    return true;
+}
+
+Modelo Modelo::carregar(const string& caminho) {
+    ifstream arquivo(caminho, ios::binary);
+
+    if (!arquivo.is_open()) {
+        throw runtime_error("Erro ao abrir o modelo: " + caminho);
+    }
+
+    char magico[4];
+    uint32_t versao;
+    uint32_t tipo;
+    uint64_t numCentroides;
+    uint64_t dimensao;
+
+    arquivo.read(magico, sizeof(magico));
+    lerValor(arquivo, versao);
+    lerValor(arquivo, tipo);
+    lerValor(arquivo, numCentroides);
+    lerValor(arquivo, dimensao);
+
+    if (!arquivo || !equal(magico, magico + 4, MAGICO) || versao < 1 || versao > VERSAO_MODELO) {
+        throw runtime_error("Arquivo de modelo invalido: " + caminho);
+    }
+    if (tipo != FLOAT64 && tipo != FLOAT32) {
+        throw runtime_error("Tipo de dados desconhecido no modelo: " + caminho);
+    }
+
+    Modelo modelo;
+    modelo.numCentroides = numCentroides;
+    modelo.dimensao = dimensao;
+    lerValor(arquivo, modelo.numInstanciasTreino);
+    lerValor(arquivo, modelo.inercia);
+    lerValor(arquivo, modelo.dataTreino);
+
+    // K e d só são usados nas alocações depois de conferidos com o tamanho do arquivo, para que um
+    // cabeçalho corrompido não peça mais memória do que o arquivo contém
+    const uint64_t inicioDados = arquivo.tellg();
+    arquivo.seekg(0, ios::end);
+    const uint64_t tamanhoArquivo = arquivo.tellg();
+    arquivo.seekg(inicioDados);
+    const uint64_t restante = tamanhoArquivo >= inicioDados ? tamanhoArquivo - inicioDados : 0;
+    const uint64_t bytesPorValor = tipo == FLOAT32 ? sizeof(float) : sizeof(double);
+    if (!arquivo || numCentroides == 0 || dimensao == 0 || dimensao > restante / bytesPorValor) {
+        throw runtime_error("Arquivo de modelo invalido: " + caminho);
+    }
+    uint64_t bytesPorCentroide = dimensao * bytesPorValor + sizeof(double);
+    if (versao >= 2) {
+        bytesPorCentroide += dimensao * sizeof(double) + 2 * sizeof(double) + sizeof(uint64_t);
+    }
+    if (numCentroides > restante / bytesPorCentroide || numCentroides * bytesPorCentroide != restante) {
+        throw runtime_error("Arquivo de modelo truncado: " + caminho);
+    }
+
+    modelo.centroides.resize(numCentroides * dimensao);
+    if (tipo == FLOAT32) {
+        vector<float> reduzidos(numCentroides * dimensao);
+        arquivo.read(reinterpret_cast<char*>(reduzidos.data()), reduzidos.size() * sizeof(float));
+        copy(reduzidos.begin(), reduzidos.end(), modelo.centroides.begin());
+    } else {
+        arquivo.read(reinterpret_cast<char*>(modelo.centroides.data()), modelo.centroides.size() * sizeof(double));
+    }
+
+    modelo.normas.resize(numCentroides);
+    arquivo.read(reinterpret_cast<char*>(modelo.normas.data()), modelo.normas.size() * sizeof(double));
+
+    // Modelos da versão 1 não têm estatísticas e ficam com massas nulas
+    modelo.somas.assign(numCentroides * dimensao, 0.0);
+    modelo.massas.assign(numCentroides, 0.0);
+    modelo.contagens.assign(numCentroides, 0);
+    modelo.somasQuadrados.assign(numCentroides, 0.0);
+    if (versao >= 2) {
+        arquivo.read(reinterpret_cast<char*>(modelo.somas.data()), modelo.somas.size() * sizeof(double));
+        arquivo.read(reinterpret_cast<char*>(modelo.massas.data()), modelo.massas.size() * sizeof(double));
+        arquivo.read(reinterpret_cast<char*>(modelo.contagens.data()), modelo.contagens.size() * sizeof(uint64_t));
+        arquivo.read(reinterpret_cast<char*>(modelo.somasQuadrados.data()), modelo.somasQuadrados.size() * sizeof(double));
+    }
+
+    if (!arquivo) {
+        throw runtime_error("Arquivo de modelo truncado: " + caminho);
+    }
+
+    return modelo;
+}
+
+// Produto interno com quatro acumuladores independentes, para o compilador vetorizar
+static inline double produtoInterno(const double* a, const double* b, size_t d) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t j = 0;
+    for (; j + 4 <= d; j += 4) {
+        s0 += a[j] * b[j];
+        s1 += a[j + 1] * b[j + 1];
+        s2 += a[j + 2] * b[j + 2];
+        s3 += a[j + 3] * b[j + 3];
+    }
+    for (; j < d; ++j) {
+        s0 += a[j] * b[j];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+vector<int> Modelo::predizer(const double* pontos, size_t numPontos) const {
+    vector<int> rotulos(numPontos);
+    if (numPontos == 0) return rotulos;
+
+    // ||x - c||^2 = ||x||^2 - 2 x.c + ||c||^2; ||x||^2 não muda o argmin
+    auto predizerIntervalo = [&](size_t inicio, size_t fim) {
+        const size_t BLOCO = 64;
+        vector<double> melhores(BLOCO);
+
+        for (size_t bloco = inicio; bloco < fim; bloco += BLOCO) {
+            size_t fimBloco = min(bloco + BLOCO, fim);
+            fill(melhores.begin(), melhores.end(), numeric_limits<double>::max());
+
+            // Cada centroide é reaproveitado por todo o bloco de pontos enquanto está em cache
+            for (size_t k = 0; k < numCentroides; ++k) {
+                const double* centroide = centroides.data() + k * dimensao;
+                for (size_t i = bloco; i < fimBloco; ++i) {
+                    double distancia = normas[k] - 2.0 * produtoInterno(pontos + i * dimensao, centroide, dimensao);
+                    if (distancia < melhores[i - bloco]) {
+                        melhores[i - bloco] = distancia;
+                        rotulos[i] = k;
+                    }
+                }
+            }
+        }
+    };
+
+    size_t numThreads = max(1u, thread::hardware_concurrency());
+    size_t chunkSize = max<size_t>((numPontos + numThreads - 1) / numThreads, 1024);
+
+    // Lotes pequenos rodam na própria thread, evitando o custo de criar threads por chamada
+    if (chunkSize >= numPontos) {
+        predizerIntervalo(0, numPontos);
+        return rotulos;
+    }
+
+    vector<future<void>> futures;
+
+    for (size_t inicio = 0; inicio < numPontos; inicio += chunkSize) {
+        futures.push_back(async(launch::async, predizerIntervalo, inicio, min(inicio + chunkSize, numPontos)));
+    }
+
+    for (auto& fut : futures) {
+        fut.get();
+    }
+
+    return rotulos;
+}
+
+vector<int> Modelo::predizer(const vector<Instancia>& instancias) const {
+    vector<double> pontos;
+    pontos.reserve(instancias.size() * dimensao);
+    for (const Instancia& instancia : instancias) {
+        const vector<double> atributos = instancia.getAtributos();
+        if (atributos.size() != dimensao) {
+            throw invalid_argument("A dimensao das instancias difere da dimensao do modelo.");
+        }
+        pontos.insert(pontos.end(), atributos.begin(), atributos.end());
+    }
+    return predizer(pontos.data(), instancias.size());
+}
+
+// Centroides e normas a partir das estatísticas; clusters sem massa mantêm a posição
+void Modelo::recalcularCentroides() {
+    for (size_t k = 0; k < numCentroides; ++k) {
+        if (massas[k] <= 0.0) continue;
+        double norma = 0.0;
+        for (size_t j = 0; j < dimensao; ++j) {
+            double valor = somas[k * dimensao + j] / massas[k];
+            centroides[k * dimensao + j] = valor;
+            norma += valor * valor;
+        }
+        normas[k] = norma;
+    }
+}
+
+// Executa funcao(parte, inicio, fim) em partes de [0, n) distribuídas entre as CPUs; retorna o número de partes
+static size_t executarEmPartes(size_t n, const function<void(size_t, size_t, size_t)>& funcao) {
+    size_t numThreads = max(1u, thread::hardware_concurrency());
+    size_t chunkSize = max<size_t>((n + numThreads - 1) / numThreads, 1);
+    vector<future<void>> futures;
+
+    size_t parte = 0;
+    for (size_t inicio = 0; inicio < n; inicio += chunkSize, ++parte) {
+        futures.push_back(async(launch::async, funcao, parte, inicio, min(inicio + chunkSize, n)));
+    }
+    for (auto& fut : futures) {
+        fut.get();
+    }
+    return parte;
+}
+
+Modelo::ResultadoAtualizacao Modelo::atualizar(const vector<Instancia>& novas, const vector<Instancia>& historico, int maxIteracoes) {
+    if (!temEstatisticas() && historico.empty()) {
+        throw runtime_error("O modelo nao tem as estatisticas dos clusters necessarias para o warm start.");
+    }
+
+    const size_t K = numCentroides;
+    const size_t d = dimensao;
+    ResultadoAtualizacao resultado{0, 0, 0};
+
+    auto linhasDe = [&](const vector<Instancia>& instancias) {
+        vector<double> linhas;
+        linhas.reserve(instancias.size() * d);
+        for (const Instancia& instancia : instancias) {
+            const vector<double> atributos = instancia.getAtributos();
+            if (atributos.size() != d) {
+                throw invalid_argument("A dimensao das instancias difere da dimensao do modelo.");
+            }
+            linhas.insert(linhas.end(), atributos.begin(), atributos.end());
+        }
+        return linhas;
+    };
+    const vector<double> linhasNovas = linhasDe(novas);
+    const vector<double> linhasHistorico = linhasDe(historico);
+
+    // Adiciona (sinal 1) ou retira (sinal -1) uma instância das estatísticas do cluster k
+    auto contabilizar = [&](const double* linha, double peso, int k, int sinal) {
+        double norma = 0.0;
+        for (size_t j = 0; j < d; ++j) {
+            somas[k * d + j] += sinal * peso * linha[j];
+            norma += linha[j] * linha[j];
+        }
+        somasQuadrados[k] += sinal * peso * norma;
+        massas[k] += sinal * peso;
+        contagens[k] += sinal;
+    };
+
+    auto distancia = [&](const double* linha, size_t k) {
+        const double* centroide = centroides.data() + k * d;
+        double soma = 0.0;
+        for (size_t j = 0; j < d; ++j) {
+            double diferenca = linha[j] - centroide[j];
+            soma += diferenca * diferenca;
+        }
+        return sqrt(soma);
+    };
+
+    // Centroide mais próximo, distância a ele (limite superior) e ao segundo (limite inferior)
+    auto atribuirComLimites = [&](const double* linha, int& rotulo, double& superior, double& inferior) {
+        superior = numeric_limits<double>::max();
+        inferior = numeric_limits<double>::max();
+        for (size_t k = 0; k < K; ++k) {
+            double dist = distancia(linha, k);
+            if (dist < superior) {
+                inferior = superior;
+                superior = dist;
+                rotulo = k;
+            } else if (dist < inferior) {
+                inferior = dist;
+            }
+        }
+    };
+
+    const size_t numHistorico = historico.size();
+    vector<int> rotulosHistorico(numHistorico);
+    vector<double> superiores(numHistorico), inferiores(numHistorico);
+
+    // Recalcula os centroides e ajusta os limites do histórico pelo deslocamento de cada um,
+    // sem recalcular distâncias
+    auto moverCentroides = [&]() {
+        vector<double> anteriores = centroides;
+        recalcularCentroides();
+        if (numHistorico == 0) return;
+
+        vector<double> deslocamentos(K, 0.0);
+        double maiorDeslocamento = 0.0;
+        for (size_t k = 0; k < K; ++k) {
+            for (size_t j = 0; j < d; ++j) {
+                double diferenca = centroides[k * d + j] - anteriores[k * d + j];
+                deslocamentos[k] += diferenca * diferenca;
+            }
+            deslocamentos[k] = sqrt(deslocamentos[k]);
+            maiorDeslocamento = max(maiorDeslocamento, deslocamentos[k]);
+        }
+        for (size_t i = 0; i < numHistorico; ++i) {
+            superiores[i] += deslocamentos[rotulosHistorico[i]];
+            inferiores[i] -= maiorDeslocamento;
+        }
+    };
+
+    // Com o histórico, as estatísticas guardadas são refeitas a partir das atribuições atuais
+    if (numHistorico > 0) {
+        executarEmPartes(numHistorico, [&](size_t, size_t inicio, size_t fim) {
+            for (size_t i = inicio; i < fim; ++i) {
+                atribuirComLimites(linhasHistorico.data() + i * d, rotulosHistorico[i], superiores[i], inferiores[i]);
+            }
+        });
+
+        fill(somas.begin(), somas.end(), 0.0);
+        fill(massas.begin(), massas.end(), 0.0);
+        fill(contagens.begin(), contagens.end(), 0);
+        fill(somasQuadrados.begin(), somasQuadrados.end(), 0.0);
+        for (size_t i = 0; i < numHistorico; ++i) {
+            contabilizar(linhasHistorico.data() + i * d, historico[i].getPeso(), rotulosHistorico[i], 1);
+        }
+        moverCentroides();
+    }
+
+    vector<int> rotulosNovos(novas.size(), -1);
+    for (int iteracao = 1; iteracao <= maxIteracoes; ++iteracao) {
+        size_t mudancasPassada = 0;
+
+        // Novas instâncias: atribuição completa, com as estatísticas corrigidas só para quem mudou
+        vector<int> atribuidos = predizer(linhasNovas.data(), novas.size());
+        for (size_t i = 0; i < novas.size(); ++i) {
+            if (atribuidos[i] == rotulosNovos[i]) continue;
+            const double* linha = linhasNovas.data() + i * d;
+            if (rotulosNovos[i] >= 0) {
+                contabilizar(linha, novas[i].getPeso(), rotulosNovos[i], -1);
+                resultado.mudancas++;
+            }
+            contabilizar(linha, novas[i].getPeso(), atribuidos[i], 1);
+            rotulosNovos[i] = atribuidos[i];
+            mudancasPassada++;
+        }
+
+        // Histórico: pelo teste de Hamerly, só quem pode ter mudado tem as distâncias recalculadas
+        if (numHistorico > 0) {
+            vector<vector<pair<size_t, int>>> movidos(thread::hardware_concurrency() + 1);
+            vector<size_t> evitadas(movidos.size(), 0);
+            executarEmPartes(numHistorico, [&](size_t parte, size_t inicio, size_t fim) {
+                for (size_t i = inicio; i < fim; ++i) {
+                    if (superiores[i] <= inferiores[i]) {
+                        evitadas[parte] += K;
+                        continue;
+                    }
+                    const double* linha = linhasHistorico.data() + i * d;
+                    superiores[i] = distancia(linha, rotulosHistorico[i]);
+                    if (superiores[i] <= inferiores[i]) {
+                        evitadas[parte] += K - 1;
+                        continue;
+                    }
+                    int rotulo = rotulosHistorico[i];
+                    atribuirComLimites(linha, rotulo, superiores[i], inferiores[i]);
+                    if (rotulo != rotulosHistorico[i]) {
+                        movidos[parte].push_back({i, rotulo});
+                    }
+                }
+            });
+
+            for (size_t parte = 0; parte < movidos.size(); ++parte) {
+                resultado.distanciasEvitadas += evitadas[parte];
+                for (const auto& movido : movidos[parte]) {
+                    const double* linha = linhasHistorico.data() + movido.first * d;
+                    double peso = historico[movido.first].getPeso();
+                    contabilizar(linha, peso, rotulosHistorico[movido.first], -1);
+                    contabilizar(linha, peso, movido.second, 1);
+                    rotulosHistorico[movido.first] = movido.second;
+                    resultado.mudancas++;
+                    mudancasPassada++;
+                }
+            }
+        }
+
+        resultado.iteracoes = iteracao;
+        if (mudancasPassada == 0) break;
+
+        moverCentroides();
+    }
+
+    // Com os centroides nas médias, a SSE de cada cluster é sum w||x||^2 - ||soma||^2 / massa
+    inercia = 0.0;
+    for (size_t k = 0; k < K; ++k) {
+        if (massas[k] <= 0.0) continue;
+        double normaSoma = 0.0;
+        for (size_t j = 0; j < d; ++j) {
+            normaSoma += somas[k * d + j] * somas[k * d + j];
+        }
+        inercia += max(somasQuadrados[k] - normaSoma / massas[k], 0.0);
+    }
+
+    numInstanciasTreino = (numHistorico > 0 ? numHistorico : numInstanciasTreino) + novas.size();
+    dataTreino = chrono::duration_cast<chrono::seconds>(chrono::system_clock::now().time_since_epoch()).count();
+    return resultado;
+}
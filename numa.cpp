@@ -0,0 +1,311 @@
+#include "Library/numa.h"
+#include "Library/soma.h"
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <future>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <iterator>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Construtores
+TopologiaNuma::TopologiaNuma(vector<vector<int>> cpusPorNo) : cpusPorNo(cpusPorNo) {}
+
+// Getters
+int TopologiaNuma::getNumNos() const {
+    return cpusPorNo.size();
+}
+
+int TopologiaNuma::getNumCpus() const {
+    int total = 0;
+    for (const auto& cpus : cpusPorNo) {
+        total += cpus.size();
+    }
+    return total;
+}
+
+const vector<int>& TopologiaNuma::getCpus(int no) const {
+    return cpusPorNo[no];
+}
+
+// Converte uma cpulist do kernel ("0-3,8-11") em lista de CPUs
+vector<int> lerListaCpus(const string& texto) {
+    vector<int> cpus;
+    stringstream ss(texto);
+    string intervalo;
+
+    while (getline(ss, intervalo, ',')) {
+        if (intervalo.empty() || intervalo == "\n") continue;
+        size_t traco = intervalo.find('-');
+        int inicio = stoi(intervalo.substr(0, traco));
+        int fim = (traco == string::npos) ? inicio : stoi(intervalo.substr(traco + 1));
+        for (int cpu = inicio; cpu <= fim; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+
+    return cpus;
+}
+
+TopologiaNuma TopologiaNuma::detectar() {
+    vector<vector<int>> cpusPorNo;
+    fs::path raiz = "/sys/devices/system/node";
+
+    error_code erro;
+    if (fs::exists(raiz, erro)) {
+        vector<pair<int, vector<int>>> nos;
+        for (const auto& entrada : fs::directory_iterator(raiz, erro)) {
+            string nome = entrada.path().filename().string();
+            if (nome.rfind("node", 0) != 0 || nome.size() == 4 || !isdigit(nome[4])) continue;
+
+            ifstream arquivo(entrada.path() / "cpulist");
+            string linha;
+            if (!arquivo.is_open() || !getline(arquivo, linha)) continue;
+
+            vector<int> cpus = lerListaCpus(linha);
+            if (!cpus.empty()) {
+                nos.push_back({stoi(nome.substr(4)), cpus});
+            }
+        }
+
+        sort(nos.begin(), nos.end());
+        for (auto& no : nos) {
+            cpusPorNo.push_back(move(no.second));
+        }
+    }
+
+    if (cpusPorNo.empty()) {
+        int numCpus = max(1u, thread::hardware_concurrency());
+        vector<int> cpus(numCpus);
+        for (int i = 0; i < numCpus; ++i) {
+            cpus[i] = i;
+        }
+        cpusPorNo.push_back(move(cpus));
+    }
+
+    return TopologiaNuma(cpusPorNo);
+}
+
+bool TopologiaNuma::fixarThreadNoNo(int no) const {
+#ifdef __linux__
+    if (cpusPorNo.size() <= 1) return false;
+
+    cpu_set_t conjunto;
+    CPU_ZERO(&conjunto);
+    for (int cpu : cpusPorNo[no]) {
+        CPU_SET(cpu, &conjunto);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(conjunto), &conjunto) == 0;
+#else
+    return false;
+#endif
+}
+
+// Construtores
+DadosNuma::DadosNuma(const vector<Instancia>& instancias, const TopologiaNuma& topologia, size_t numThreads)
+    : topologia(topologia), numInstancias(instancias.size()), dimensao(0) {
+    if (instancias.empty()) {
+        throw invalid_argument("A base de dados esta vazia.");
+    }
+    dimensao = instancias[0].getAtributos().size();
+
+    if (numThreads == 0) {
+        numThreads = topologia.getNumCpus();
+    }
+    numThreads = max<size_t>(1, min(numThreads, numInstancias));
+
+    // Distribui as threads entre os nós proporcionalmente ao número de CPUs de cada um
+    vector<int> nosDasThreads;
+    int totalCpus = topologia.getNumCpus();
+    for (int no = 0; no < topologia.getNumNos(); ++no) {
+        size_t threadsNoNo = (numThreads * topologia.getCpus(no).size() + totalCpus - 1) / totalCpus;
+        for (size_t t = 0; t < threadsNoNo && nosDasThreads.size() < numThreads; ++t) {
+            nosDasThreads.push_back(no);
+        }
+    }
+
+    // Partições alinhadas aos blocos da soma em árvore, para que a redução não dependa do número de threads
+    size_t tamanho = (numInstancias + nosDasThreads.size() - 1) / nosDasThreads.size();
+    tamanho = (tamanho + SomaEmArvore::TAMANHO_BLOCO - 1) / SomaEmArvore::TAMANHO_BLOCO * SomaEmArvore::TAMANHO_BLOCO;
+    for (size_t t = 0; t < nosDasThreads.size(); ++t) {
+        size_t inicio = t * tamanho;
+        size_t fim = min(inicio + tamanho, numInstancias);
+        if (inicio < fim) {
+            particoes.push_back({nosDasThreads[t], inicio, fim, {}, {}});
+        }
+    }
+
+    // Cada partição é alocada e preenchida por uma thread fixada no seu nó (first-touch)
+    vector<future<void>> futures;
+    for (auto& particao : particoes) {
+        futures.push_back(async(launch::async, [&]() {
+            this->topologia.fixarThreadNoNo(particao.no);
+            particao.linhas.resize((particao.fim - particao.inicio) * dimensao);
+            particao.pesos.resize(particao.fim - particao.inicio);
+            double* destino = particao.linhas.data();
+            for (size_t i = particao.inicio; i < particao.fim; ++i) {
+                const vector<double> atributos = instancias[i].getAtributos();
+                copy(atributos.begin(), atributos.end(), destino);
+                particao.pesos[i - particao.inicio] = instancias[i].getPeso();
+                destino += dimensao;
+            }
+        }));
+    }
+
+    for (auto& fut : futures) {
+        fut.get();
+    }
+
+    replicas.resize(topologia.getNumNos());
+}
+
+// Getters
+const TopologiaNuma& DadosNuma::getTopologia() const {
+    return topologia;
+}
+
+size_t DadosNuma::getNumInstancias() const {
+    return numInstancias;
+}
+
+size_t DadosNuma::getDimensao() const {
+    return dimensao;
+}
+
+const vector<DadosNuma::Particao>& DadosNuma::getParticoes() const {
+    return particoes;
+}
+
+const vector<double>& DadosNuma::getReplica(int no) const {
+    return replicas[no];
+}
+
+void DadosNuma::replicarCentroides(const vector<Centroide>& centroides) {
+    vector<future<void>> futures;
+
+    for (int no = 0; no < topologia.getNumNos(); ++no) {
+        futures.push_back(async(launch::async, [&, no]() {
+            topologia.fixarThreadNoNo(no);
+            vector<double>& replica = replicas[no];
+            replica.resize(centroides.size() * dimensao);
+            for (size_t k = 0; k < centroides.size(); ++k) {
+                const vector<double> atributos = centroides[k].getAtributos();
+                copy(atributos.begin(), atributos.end(), replica.begin() + k * dimensao);
+            }
+        }));
+    }
+
+    for (auto& fut : futures) {
+        fut.get();
+    }
+}
+
+// Cada thread fica fixada no nó dono da sua partição, lê a réplica local dos centroides e acumula
+// somas/massas por bloco de instâncias; os blocos são reduzidos pela soma em árvore de ordem fixa.
+void DadosNuma::atribuir(const vector<Centroide>& centroides, Atribuicao& atribuicao) {
+    const size_t K = centroides.size();
+    const size_t d = dimensao;
+    const size_t numBlocos = SomaEmArvore::numBlocos(numInstancias);
+
+    // Rótulos -1 na primeira passada: todas as instâncias contam como mudança
+    if (atribuicao.rotulos.size() != numInstancias) {
+        atribuicao.rotulos.assign(numInstancias, -1);
+    }
+    atribuicao.distancias.resize(numInstancias);
+    replicarCentroides(centroides);
+
+    vector<vector<SomaEmArvore::No>> nosParciais(particoes.size());
+    vector<vector<int>> contagensParciais(particoes.size());
+    vector<size_t> mudancasParciais(particoes.size(), 0);
+    vector<future<void>> futures;
+
+    for (size_t p = 0; p < particoes.size(); ++p) {
+        futures.push_back(async(launch::async, [&, p]() {
+            const Particao& particao = particoes[p];
+            topologia.fixarThreadNoNo(particao.no);
+
+            const double* replica = replicas[particao.no].data();
+            SomaEmArvore::Pilha pilha(numBlocos);
+            vector<int> contagens(K, 0);
+            size_t mudancas = 0;
+
+            for (size_t inicioBloco = particao.inicio; inicioBloco < particao.fim; inicioBloco += SomaEmArvore::TAMANHO_BLOCO) {
+                size_t fimBloco = min(inicioBloco + SomaEmArvore::TAMANHO_BLOCO, particao.fim);
+
+                // Somas (K x d) seguidas das massas (K) e da inércia do bloco
+                vector<double> parcial(K * d + K + 1, 0.0);
+                double* massas = parcial.data() + K * d;
+
+                for (size_t i = inicioBloco; i < fimBloco; ++i) {
+                    const double* linha = particao.linhas.data() + (i - particao.inicio) * d;
+                    size_t indiceCentroideProximo = 0;
+                    double menorDistancia = numeric_limits<double>::max();
+
+                    for (size_t k = 0; k < K; ++k) {
+                        const double* centroide = replica + k * d;
+                        double distancia = 0.0;
+                        for (size_t j = 0; j < d; ++j) {
+                            double diferenca = linha[j] - centroide[j];
+                            distancia += diferenca * diferenca;
+                        }
+                        if (distancia < menorDistancia) {
+                            menorDistancia = distancia;
+                            indiceCentroideProximo = k;
+                        }
+                    }
+
+                    double peso = particao.pesos[i - particao.inicio];
+                    mudancas += atribuicao.rotulos[i] != (int) indiceCentroideProximo;
+                    atribuicao.rotulos[i] = indiceCentroideProximo;
+                    atribuicao.distancias[i] = menorDistancia;
+                    contagens[indiceCentroideProximo]++;
+                    massas[indiceCentroideProximo] += peso;
+                    parcial[K * d + K] += peso * menorDistancia;
+                    double* soma = parcial.data() + indiceCentroideProximo * d;
+                    for (size_t j = 0; j < d; ++j) {
+                        soma[j] += peso * linha[j];
+                    }
+                }
+
+                pilha.adicionar(inicioBloco / SomaEmArvore::TAMANHO_BLOCO, move(parcial));
+            }
+
+            nosParciais[p] = move(pilha.getNos());
+            contagensParciais[p] = move(contagens);
+            mudancasParciais[p] = mudancas;
+        }));
+    }
+
+    for (auto& fut : futures) {
+        fut.get();
+    }
+
+    vector<SomaEmArvore::No> nos;
+    atribuicao.contagens.assign(K, 0);
+    atribuicao.mudancas = 0;
+    for (size_t p = 0; p < particoes.size(); ++p) {
+        atribuicao.mudancas += mudancasParciais[p];
+        nos.insert(nos.end(), make_move_iterator(nosParciais[p].begin()), make_move_iterator(nosParciais[p].end()));
+        for (size_t k = 0; k < K; ++k) {
+            atribuicao.contagens[k] += contagensParciais[p][k];
+        }
+    }
+
+    vector<double> total = SomaEmArvore::combinar(move(nos), numBlocos, K * d + K + 1);
+    atribuicao.inercia = total[K * d + K];
+    atribuicao.distanciasCalculadas = numInstancias * K;
+    atribuicao.distanciasEvitadas = 0;
+    atribuicao.massas.assign(total.begin() + K * d, total.begin() + K * d + K);
+    total.resize(K * d);
+    atribuicao.somas = move(total);
+}
@@ -0,0 +1,182 @@
+#include "Library/pontocontrole.h"
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <chrono>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const char MAGICO[4] = {'K', 'M', 'C', 'K'};
+static const uint32_t VERSAO_PONTO_DE_CONTROLE = 1;
+
+template <typename T>
+static void escreverValor(ofstream& arquivo, const T& valor) {
+    arquivo.write(reinterpret_cast<const char*>(&valor), sizeof(T));
+}
+
+template <typename T>
+static void escreverVetor(ofstream& arquivo, const vector<T>& valores) {
+    arquivo.write(reinterpret_cast<const char*>(valores.data()), valores.size() * sizeof(T));
+}
+
+template <typename T>
+static void lerValor(ifstream& arquivo, T& valor) {
+    arquivo.read(reinterpret_cast<char*>(&valor), sizeof(T));
+}
+
+template <typename T>
+static void lerVetor(ifstream& arquivo, vector<T>& valores, size_t tamanho) {
+    valores.resize(tamanho);
+    arquivo.read(reinterpret_cast<char*>(valores.data()), tamanho * sizeof(T));
+}
+
+void PontoDeControle::salvar(const string& caminho) const {
+    const string temporario = caminho + ".tmp";
+    ofstream arquivo(temporario, ios::binary);
+
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir o arquivo para escrita: " << temporario << endl;
+        return;
+    }
+
+    arquivo.write(MAGICO, sizeof(MAGICO));
+    escreverValor(arquivo, VERSAO_PONTO_DE_CONTROLE);
+    escreverValor(arquivo, semente);
+    escreverValor(arquivo, iteracao);
+    escreverValor(arquivo, numCentroides);
+    escreverValor(arquivo, dimensao);
+    escreverValor(arquivo, numInstancias);
+    escreverValor(arquivo, inerciaAnterior);
+    escreverValor(arquivo, static_cast<uint8_t>(!distancias.empty()));
+    escreverVetor(arquivo, posicoes);
+    escreverVetor(arquivo, somas);
+    escreverVetor(arquivo, massas);
+    escreverVetor(arquivo, contagens);
+    escreverVetor(arquivo, rotulos);
+    escreverVetor(arquivo, distancias);
+    arquivo.close();
+
+    if (!arquivo) {
+        cerr << "Erro ao gravar o ponto de controle: " << temporario << endl;
+        remove(temporario.c_str());
+        return;
+    }
+
+#ifdef __unix__
+    // Sem o fsync, uma queda logo após o rename pode deixar o novo nome apontando para dados vazios
+    int descritor = open(temporario.c_str(), O_RDONLY);
+    if (descritor >= 0) {
+        fsync(descritor);
+        close(descritor);
+    }
+#endif
+
+    if (rename(temporario.c_str(), caminho.c_str()) != 0) {
+        cerr << "Erro ao substituir o ponto de controle: " << caminho << endl;
+    }
+}
+
+bool PontoDeControle::carregar(const string& caminho, PontoDeControle& estado) {
+    ifstream arquivo(caminho, ios::binary);
+
+    if (!arquivo.is_open()) {
+        return false;
+    }
+
+    char magico[4];
+    uint32_t versao;
+    uint8_t temDistancias;
+
+    arquivo.read(magico, sizeof(magico));
+    lerValor(arquivo, versao);
+    if (!arquivo || !equal(magico, magico + 4, MAGICO) || versao != VERSAO_PONTO_DE_CONTROLE) {
+        throw runtime_error("Arquivo de ponto de controle invalido: " + caminho);
+    }
+
+    lerValor(arquivo, estado.semente);
+    lerValor(arquivo, estado.iteracao);
+    lerValor(arquivo, estado.numCentroides);
+    lerValor(arquivo, estado.dimensao);
+    lerValor(arquivo, estado.numInstancias);
+    lerValor(arquivo, estado.inerciaAnterior);
+    lerValor(arquivo, temDistancias);
+    if (!arquivo || temDistancias > 1) {
+        throw runtime_error("Arquivo de ponto de controle invalido: " + caminho);
+    }
+
+    // K, d e n só são usados nas alocações depois de conferidos com o tamanho do arquivo, para que
+    // um cabeçalho corrompido não peça mais memória do que o arquivo contém
+    const uint64_t inicioDados = arquivo.tellg();
+    arquivo.seekg(0, ios::end);
+    const uint64_t tamanhoArquivo = arquivo.tellg();
+    arquivo.seekg(inicioDados);
+    const uint64_t restante = tamanhoArquivo >= inicioDados ? tamanhoArquivo - inicioDados : 0;
+    if (!arquivo || estado.numCentroides == 0 || estado.dimensao == 0 || estado.dimensao > restante / (2 * sizeof(double))) {
+        throw runtime_error("Arquivo de ponto de controle invalido: " + caminho);
+    }
+    // Por centroide: posição e soma (d doubles cada), massa e contagem; por instância: rótulo e,
+    // se incluída, a distância
+    const uint64_t bytesPorCentroide = 2 * estado.dimensao * sizeof(double) + sizeof(double) + sizeof(int32_t);
+    const uint64_t bytesPorInstancia = sizeof(int32_t) + (temDistancias ? sizeof(double) : 0);
+    if (estado.numCentroides > restante / bytesPorCentroide) {
+        throw runtime_error("Ponto de controle truncado: " + caminho);
+    }
+    const uint64_t restanteInstancias = restante - estado.numCentroides * bytesPorCentroide;
+    if (estado.numInstancias > restanteInstancias / bytesPorInstancia ||
+        estado.numInstancias * bytesPorInstancia != restanteInstancias) {
+        throw runtime_error("Ponto de controle truncado: " + caminho);
+    }
+
+    const size_t K = estado.numCentroides;
+    const size_t n = estado.numInstancias;
+    lerVetor(arquivo, estado.posicoes, K * estado.dimensao);
+    lerVetor(arquivo, estado.somas, K * estado.dimensao);
+    lerVetor(arquivo, estado.massas, K);
+    lerVetor(arquivo, estado.contagens, K);
+    lerVetor(arquivo, estado.rotulos, n);
+    lerVetor(arquivo, estado.distancias, temDistancias ? n : 0);
+
+    if (!arquivo) {
+        throw runtime_error("Ponto de controle truncado: " + caminho);
+    }
+    return true;
+}
+
+// Construtores
+GravadorPontoDeControle::GravadorPontoDeControle(const string& caminho) : caminho(caminho), descartados(0) {}
+
+GravadorPontoDeControle::~GravadorPontoDeControle() {
+    aguardar();
+}
+
+bool GravadorPontoDeControle::gravar(PontoDeControle estado) {
+    if (pendente.valid()) {
+        if (pendente.wait_for(chrono::seconds(0)) != future_status::ready) {
+            descartados++;
+            return false;
+        }
+        pendente.get();
+    }
+
+    pendente = async(launch::async, [this, estado = move(estado)]() {
+        estado.salvar(caminho);
+    });
+    return true;
+}
+
+size_t GravadorPontoDeControle::getDescartados() const {
+    return descartados;
+}
+
+void GravadorPontoDeControle::aguardar() {
+    if (pendente.valid()) {
+        pendente.get();
+    }
+}
@@ -0,0 +1,267 @@
+#include "Library/quantizado.h"
+#include "Library/soma.h"
+#include <future>
+#include <thread>
+#include <limits>
+#include <cmath>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+using namespace std;
+
+// Construtores
+DadosQuantizados::DadosQuantizados(const vector<Instancia>& instancias, int bits)
+    : bits(bits), numInstancias(instancias.size()), dimensao(0), reverificadas(0) {
+    if (instancias.empty()) {
+        throw invalid_argument("A base de dados esta vazia.");
+    }
+    if (bits != 8 && bits != 16) {
+        throw invalid_argument("A quantizacao aceita apenas 8 ou 16 bits.");
+    }
+    dimensao = instancias[0].getAtributos().size();
+    const size_t n = numInstancias;
+    const size_t d = dimensao;
+    const double limite = bits == 8 ? 127.0 : 32767.0;
+
+    linhas.resize(n * d);
+    pesos.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        const vector<double> atributos = instancias[i].getAtributos();
+        copy(atributos.begin(), atributos.end(), linhas.begin() + i * d);
+        pesos[i] = instancias[i].getPeso();
+    }
+
+    // Centro e escala de cada atributo: o maior desvio ocupa toda a faixa do inteiro
+    media.assign(d, 0.0);
+    escalas.assign(d, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < d; ++j) {
+            media[j] += linhas[i * d + j];
+        }
+    }
+    for (double& valor : media) {
+        valor /= n;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < d; ++j) {
+            escalas[j] = max(escalas[j], fabs(linhas[i * d + j] - media[j]));
+        }
+    }
+    for (double& escala : escalas) {
+        escala = escala > 0.0 ? escala / limite : 1.0;
+    }
+
+    if (bits == 8) {
+        codigos8.resize(n * d);
+    } else {
+        codigos16.resize(n * d);
+    }
+    normasDesvio.assign(n, 0.0);
+    normasCodigo.assign(n, 0.0);
+    normasResiduo.assign(n, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < d; ++j) {
+            double desvio = linhas[i * d + j] - media[j];
+            double codigo = max(-limite, min(limite, round(desvio / escalas[j])));
+            if (bits == 8) {
+                codigos8[i * d + j] = (int8_t) codigo;
+            } else {
+                codigos16[i * d + j] = (int16_t) codigo;
+            }
+            double residuo = desvio - escalas[j] * codigo;
+            normasDesvio[i] += desvio * desvio;
+            normasCodigo[i] += codigo * codigo;
+            normasResiduo[i] += residuo * residuo;
+        }
+        normasCodigo[i] = sqrt(normasCodigo[i]);
+        normasResiduo[i] = sqrt(normasResiduo[i]);
+    }
+}
+
+// Getters
+size_t DadosQuantizados::getNumInstancias() const {
+    return numInstancias;
+}
+
+size_t DadosQuantizados::getDimensao() const {
+    return dimensao;
+}
+
+int DadosQuantizados::getBits() const {
+    return bits;
+}
+
+size_t DadosQuantizados::getReverificadas() const {
+    return reverificadas;
+}
+
+void DadosQuantizados::atribuir(const vector<Centroide>& centroides, Atribuicao& atribuicao) {
+    if (bits == 8) {
+        atribuirQuantizado(codigos8, centroides, atribuicao);
+    } else {
+        atribuirQuantizado(codigos16, centroides, atribuicao);
+    }
+}
+
+// O produto interno inteiro acumula em 32 bits para int8 (|q r| <= 127^2) e em 64 bits para int16
+template <typename T>
+void DadosQuantizados::atribuirQuantizado(const vector<T>& codigos, const vector<Centroide>& centroides, Atribuicao& atribuicao) {
+    using Acumulador = conditional_t<sizeof(T) == 1, int32_t, int64_t>;
+    const size_t K = centroides.size();
+    const size_t d = dimensao;
+    const size_t n = numInstancias;
+    const double limite = numeric_limits<T>::max();
+
+    // Por centroide: coordenadas, g = c - media, ||g||^2, ||g||, e S g quantizado com fator fatores[k]
+    // e erro de quantização ||S g - fator r||
+    vector<double> matriz(K * d);
+    vector<double> normasCentradas(K, 0.0), raizesCentradas(K), fatores(K, 1.0), errosCentroides(K, 0.0);
+    vector<T> codigosCentroides(K * d);
+    for (size_t k = 0; k < K; ++k) {
+        const vector<double> atributos = centroides[k].getAtributos();
+        copy(atributos.begin(), atributos.end(), matriz.begin() + k * d);
+
+        double maior = 0.0;
+        for (size_t j = 0; j < d; ++j) {
+            double centrado = atributos[j] - media[j];
+            normasCentradas[k] += centrado * centrado;
+            maior = max(maior, fabs(escalas[j] * centrado));
+        }
+        raizesCentradas[k] = sqrt(normasCentradas[k]);
+        fatores[k] = maior > 0.0 ? maior / limite : 1.0;
+        for (size_t j = 0; j < d; ++j) {
+            double escalado = escalas[j] * (atributos[j] - media[j]);
+            double codigo = round(escalado / fatores[k]);
+            codigosCentroides[k * d + j] = (T) codigo;
+            errosCentroides[k] += (escalado - fatores[k] * codigo) * (escalado - fatores[k] * codigo);
+        }
+        errosCentroides[k] = sqrt(errosCentroides[k]);
+    }
+
+    if (atribuicao.rotulos.size() != n) {
+        atribuicao.rotulos.assign(n, -1);
+    }
+    atribuicao.distancias.resize(n);
+
+    const size_t numBlocos = SomaEmArvore::numBlocos(n);
+    size_t numThreads = max(1u, thread::hardware_concurrency());
+    size_t chunkSize = (numBlocos + numThreads - 1) / numThreads * SomaEmArvore::TAMANHO_BLOCO;
+
+    struct Parcial {
+        vector<SomaEmArvore::No> nos;
+        vector<int> contagens;
+        size_t mudancas;
+        size_t reverificadas;
+    };
+    vector<future<Parcial>> futures;
+
+    for (size_t inicio = 0; inicio < n; inicio += chunkSize) {
+        size_t fim = min(inicio + chunkSize, n);
+        futures.push_back(async(launch::async, [&, inicio, fim]() {
+            SomaEmArvore::Pilha pilha(numBlocos);
+            vector<int> contagens(K, 0);
+            size_t mudancas = 0;
+            size_t reverificadasParcial = 0;
+            vector<double> estimativas(K), limites(K);
+
+            for (size_t inicioBloco = inicio; inicioBloco < fim; inicioBloco += SomaEmArvore::TAMANHO_BLOCO) {
+                size_t fimBloco = min(inicioBloco + SomaEmArvore::TAMANHO_BLOCO, fim);
+
+                // Somas (K x d) seguidas das massas (K) e da inércia do bloco
+                vector<double> parcial(K * d + K + 1, 0.0);
+                double* massas = parcial.data() + K * d;
+
+                for (size_t i = inicioBloco; i < fimBloco; ++i) {
+                    const T* codigo = codigos.data() + i * d;
+                    const double* linha = linhas.data() + i * d;
+                    size_t indiceCentroideProximo = 0;
+
+                    for (size_t k = 0; k < K; ++k) {
+                        const T* codigoCentroide = codigosCentroides.data() + k * d;
+                        Acumulador produto = 0;
+                        for (size_t j = 0; j < d; ++j) {
+                            produto += (Acumulador) codigo[j] * codigoCentroide[j];
+                        }
+                        estimativas[k] = normasDesvio[i] - 2.0 * fatores[k] * (double) produto + normasCentradas[k];
+                        limites[k] = 2.0 * (normasCodigo[i] * errosCentroides[k] + normasResiduo[i] * raizesCentradas[k])
+                                   + 1e-9 * (normasDesvio[i] + normasCentradas[k]);
+                        if (estimativas[k] < estimativas[indiceCentroideProximo]) {
+                            indiceCentroideProximo = k;
+                        }
+                    }
+
+                    // Ambígua quando algum outro centroide pode estar, dentro dos limites, mais perto
+                    bool ambigua = false;
+                    double teto = estimativas[indiceCentroideProximo] + limites[indiceCentroideProximo];
+                    for (size_t k = 0; k < K && !ambigua; ++k) {
+                        ambigua = k != indiceCentroideProximo && estimativas[k] - limites[k] <= teto;
+                    }
+
+                    double menorDistancia = numeric_limits<double>::max();
+                    if (ambigua) {
+                        reverificadasParcial++;
+                        for (size_t k = 0; k < K; ++k) {
+                            const double* centroide = matriz.data() + k * d;
+                            double distancia = 0.0;
+                            for (size_t j = 0; j < d; ++j) {
+                                double diferenca = linha[j] - centroide[j];
+                                distancia += diferenca * diferenca;
+                            }
+                            if (distancia < menorDistancia) {
+                                menorDistancia = distancia;
+                                indiceCentroideProximo = k;
+                            }
+                        }
+                    } else {
+                        const double* centroide = matriz.data() + indiceCentroideProximo * d;
+                        menorDistancia = 0.0;
+                        for (size_t j = 0; j < d; ++j) {
+                            double diferenca = linha[j] - centroide[j];
+                            menorDistancia += diferenca * diferenca;
+                        }
+                    }
+
+                    double peso = pesos[i];
+                    mudancas += atribuicao.rotulos[i] != (int) indiceCentroideProximo;
+                    atribuicao.rotulos[i] = indiceCentroideProximo;
+                    atribuicao.distancias[i] = menorDistancia;
+                    contagens[indiceCentroideProximo]++;
+                    massas[indiceCentroideProximo] += peso;
+                    parcial[K * d + K] += peso * menorDistancia;
+                    double* soma = parcial.data() + indiceCentroideProximo * d;
+                    for (size_t j = 0; j < d; ++j) {
+                        soma[j] += peso * linha[j];
+                    }
+                }
+
+                pilha.adicionar(inicioBloco / SomaEmArvore::TAMANHO_BLOCO, move(parcial));
+            }
+            return Parcial{move(pilha.getNos()), move(contagens), mudancas, reverificadasParcial};
+        }));
+    }
+
+    vector<SomaEmArvore::No> nos;
+    atribuicao.contagens.assign(K, 0);
+    atribuicao.mudancas = 0;
+    reverificadas = 0;
+    for (auto& fut : futures) {
+        Parcial parcial = fut.get();
+        atribuicao.mudancas += parcial.mudancas;
+        reverificadas += parcial.reverificadas;
+        nos.insert(nos.end(), make_move_iterator(parcial.nos.begin()), make_move_iterator(parcial.nos.end()));
+        for (size_t k = 0; k < K; ++k) {
+            atribuicao.contagens[k] += parcial.contagens[k];
+        }
+    }
+
+    vector<double> total = SomaEmArvore::combinar(move(nos), numBlocos, K * d + K + 1);
+    atribuicao.inercia = total[K * d + K];
+    // Exatas: todas as K das reverificadas e a do melhor centroide das demais
+    atribuicao.distanciasCalculadas = reverificadas * K + (n - reverificadas);
+    atribuicao.distanciasEvitadas = n * K - atribuicao.distanciasCalculadas;
+    atribuicao.massas.assign(total.begin() + K * d, total.begin() + K * d + K);
+    total.resize(K * d);
+    atribuicao.somas = move(total);
+}
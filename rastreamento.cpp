@@ -0,0 +1,198 @@
+#include "Library/rastreamento.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <cmath>
+#include <new>
+
+using namespace std;
+
+// Com -DKMEANS_SEM_RASTREAMENTO a classe é o esboço em linha do cabeçalho e nada daqui é compilado
+#ifndef KMEANS_SEM_RASTREAMENTO
+
+Rastreamento* Rastreamento::atual = nullptr;
+
+// A contagem de alocações troca o operator new global de todo programa que liga esta biblioteca,
+// então só é compilada quando pedida
+#ifdef KMEANS_CONTAR_ALOCACOES
+#define KMEANS_ALOCACOES_CONTADAS
+#endif
+
+#ifdef KMEANS_ALOCACOES_CONTADAS
+// Contagem de bytes alocados: um incremento atômico relaxado por alocação, e só com rastreamento ativo
+static atomic<bool> contarAlocacoes(false);
+static atomic<int64_t> totalAlocado(0);
+
+void* operator new(size_t tamanho) {
+    if (contarAlocacoes.load(memory_order_relaxed)) {
+        totalAlocado.fetch_add(tamanho, memory_order_relaxed);
+    }
+    if (void* ponteiro = malloc(tamanho ? tamanho : 1)) {
+        return ponteiro;
+    }
+    throw bad_alloc();
+}
+
+void* operator new[](size_t tamanho) {
+    return operator new(tamanho);
+}
+
+void operator delete(void* ponteiro) noexcept {
+    free(ponteiro);
+}
+
+void operator delete[](void* ponteiro) noexcept {
+    free(ponteiro);
+}
+
+void operator delete(void* ponteiro, size_t) noexcept {
+    free(ponteiro);
+}
+
+void operator delete[](void* ponteiro, size_t) noexcept {
+    free(ponteiro);
+}
+#endif
+
+// Construtores
+Rastreamento::Rastreamento(const string& caminho, Formato formato) : caminho(caminho), formato(formato), chamadas(0) {
+    atual = this;
+#ifdef KMEANS_ALOCACOES_CONTADAS
+    contarAlocacoes.store(true, memory_order_relaxed);
+#endif
+}
+
+Rastreamento::~Rastreamento() {
+    if (atual == this) {
+        atual = nullptr;
+    }
+#ifdef KMEANS_ALOCACOES_CONTADAS
+    contarAlocacoes.store(false, memory_order_relaxed);
+#endif
+
+    ofstream arquivo(caminho);
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir o arquivo de rastreamento: " << caminho << endl;
+        return;
+    }
+
+    if (formato == TRACE_CHROME) {
+        arquivo << "{\"traceEvents\":[\n";
+        for (size_t i = 0; i < eventos.size(); ++i) {
+            arquivo << eventos[i] << (i + 1 < eventos.size() ? ",\n" : "\n");
+        }
+        arquivo << "]}\n";
+    } else {
+        for (const string& evento : eventos) {
+            arquivo << evento << "\n";
+        }
+    }
+    arquivo.close();
+}
+
+Rastreamento* Rastreamento::getAtual() {
+    return atual;
+}
+
+double Rastreamento::agora() {
+    return chrono::duration<double, micro>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t Rastreamento::bytesAlocados() {
+#ifdef KMEANS_ALOCACOES_CONTADAS
+    return totalAlocado.load(memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+bool Rastreamento::contaAlocacoes() {
+#ifdef KMEANS_ALOCACOES_CONTADAS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// JSON não tem infinito nem NaN: valores não finitos saem como null
+static string numeroJson(double valor, int precisao) {
+    if (!isfinite(valor)) return "null";
+    ostringstream oss;
+    oss << setprecision(precisao) << valor;
+    return oss.str();
+}
+
+int Rastreamento::novaChamada() {
+    lock_guard<mutex> lock(mtx);
+    return ++chamadas;
+}
+
+// Evento "X" (duração completa) do trace do Chrome
+static string eventoChrome(const string& nome, double inicio, double duracao, const string& argumentos = "") {
+    ostringstream oss;
+    oss << fixed << setprecision(3) << "{\"name\":\"" << nome << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << inicio
+        << ",\"dur\":" << duracao;
+    if (!argumentos.empty()) {
+        oss << ",\"args\":{" << argumentos << "}";
+    }
+    oss << "}";
+    return oss.str();
+}
+
+void Rastreamento::registrarIteracao(const IteracaoLloyd& iteracao) {
+    ostringstream contadores;
+    contadores << "\"chamada\":" << iteracao.chamada << ",\"iteracao\":" << iteracao.iteracao
+               << ",\"inercia\":" << numeroJson(iteracao.inercia, 12) << ",\"mudancas\":" << iteracao.mudancas
+               << ",\"distancias_calculadas\":" << iteracao.distanciasCalculadas
+               << ",\"distancias_evitadas\":" << iteracao.distanciasEvitadas << ",\"bytes_alocados\":";
+    if (contaAlocacoes()) {
+        contadores << iteracao.bytesAlocados;
+    } else {
+        contadores << "null";
+    }
+
+    lock_guard<mutex> lock(mtx);
+    if (formato == TRACE_CHROME) {
+        double inicio = iteracao.inicio;
+        double total = iteracao.tempoAtribuicao + iteracao.tempoReparo + iteracao.tempoAtualizacao + iteracao.tempoConvergencia;
+        eventos.push_back(eventoChrome("iteracao", inicio, total, contadores.str()));
+        eventos.push_back(eventoChrome("atribuicao", inicio, iteracao.tempoAtribuicao));
+        inicio += iteracao.tempoAtribuicao;
+        if (iteracao.tempoReparo > 0.0) {
+            eventos.push_back(eventoChrome("reparo", inicio, iteracao.tempoReparo));
+            inicio += iteracao.tempoReparo;
+        }
+        eventos.push_back(eventoChrome("atualizacao", inicio, iteracao.tempoAtualizacao));
+        inicio += iteracao.tempoAtualizacao;
+        eventos.push_back(eventoChrome("convergencia", inicio, iteracao.tempoConvergencia));
+
+        ostringstream contador;
+        contador << fixed << setprecision(3) << "{\"name\":\"lloyd\",\"ph\":\"C\",\"pid\":1,\"ts\":" << inicio + iteracao.tempoConvergencia
+                 << ",\"args\":{\"inercia\":" << numeroJson(iteracao.inercia, 6) << ",\"mudancas\":" << iteracao.mudancas << "}}";
+        eventos.push_back(contador.str());
+    } else {
+        ostringstream oss;
+        oss << fixed << setprecision(3) << "{\"tipo\":\"iteracao\"," << contadores.str()
+            << ",\"atribuicao_us\":" << iteracao.tempoAtribuicao << ",\"reparo_us\":" << iteracao.tempoReparo
+            << ",\"atualizacao_us\":" << iteracao.tempoAtualizacao << ",\"convergencia_us\":" << iteracao.tempoConvergencia << "}";
+        eventos.push_back(oss.str());
+    }
+}
+
+void Rastreamento::registrarFase(const string& nome, double inicio, double duracao) {
+    lock_guard<mutex> lock(mtx);
+    if (formato == TRACE_CHROME) {
+        eventos.push_back(eventoChrome(nome, inicio, duracao));
+    } else {
+        ostringstream oss;
+        oss << fixed << setprecision(3) << "{\"tipo\":\"fase\",\"nome\":\"" << nome << "\",\"inicio_us\":" << inicio
+            << ",\"duracao_us\":" << duracao << "}";
+        eventos.push_back(oss.str());
+    }
+}
+
+#endif
@@ -0,0 +1,387 @@
+#include "Library/reducao.h"
+#include "Library/aleatorio.h"
+#include "Library/soma.h"
+#include <future>
+#include <thread>
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+
+using namespace std;
+
+// Executa funcao(inicio, fim) em blocos de [0, n) distribuídos entre as CPUs
+static void paraCadaBloco(size_t n, const function<void(size_t, size_t)>& funcao) {
+    size_t numThreads = max(1u, thread::hardware_concurrency());
+    size_t chunkSize = (n + numThreads - 1) / numThreads;
+    vector<future<void>> futures;
+
+    for (size_t bloco = 0; bloco * chunkSize < n; ++bloco) {
+        size_t inicio = bloco * chunkSize;
+        futures.push_back(async(launch::async, funcao, inicio, min(inicio + chunkSize, n)));
+    }
+
+    for (auto& fut : futures) {
+        fut.get();
+    }
+}
+
+// Soma sobre [0, n) de parciais de `tamanho` valores calculadas por parcial(inicio, fim, valores) em
+// blocos fixos de SomaEmArvore::TAMANHO_BLOCO linhas; o resultado não depende do número de threads
+static vector<double> somarPorBloco(size_t n, size_t tamanho, const function<void(size_t, size_t, vector<double>&)>& parcial) {
+    const size_t numBlocos = SomaEmArvore::numBlocos(n);
+    size_t numThreads = max(1u, thread::hardware_concurrency());
+    size_t chunkSize = (numBlocos + numThreads - 1) / numThreads * SomaEmArvore::TAMANHO_BLOCO;
+    vector<future<vector<SomaEmArvore::No>>> futures;
+
+    for (size_t inicio = 0; inicio < n; inicio += chunkSize) {
+        size_t fim = min(inicio + chunkSize, n);
+        futures.push_back(async(launch::async, [&, inicio, fim]() {
+            SomaEmArvore::Pilha pilha(numBlocos);
+            for (size_t inicioBloco = inicio; inicioBloco < fim; inicioBloco += SomaEmArvore::TAMANHO_BLOCO) {
+                vector<double> valores(tamanho, 0.0);
+                parcial(inicioBloco, min(inicioBloco + SomaEmArvore::TAMANHO_BLOCO, fim), valores);
+                pilha.adicionar(inicioBloco / SomaEmArvore::TAMANHO_BLOCO, move(valores));
+            }
+            return move(pilha.getNos());
+        }));
+    }
+
+    vector<SomaEmArvore::No> nos;
+    for (auto& fut : futures) {
+        vector<SomaEmArvore::No> parciais = fut.get();
+        nos.insert(nos.end(), make_move_iterator(parciais.begin()), make_move_iterator(parciais.end()));
+    }
+    return SomaEmArvore::combinar(move(nos), numBlocos, tamanho);
+}
+
+// Autovalores (decrescentes) e autovetores (colunas de vetores) de uma matriz simétrica m x m, por Jacobi
+static void autodecomposicao(vector<double> matriz, size_t m, vector<double>& valores, vector<double>& vetores) {
+    vector<double> V(m * m, 0.0);
+    for (size_t i = 0; i < m; ++i) {
+        V[i * m + i] = 1.0;
+    }
+
+    for (int varredura = 0; varredura < 100; ++varredura) {
+        double foraDiagonal = 0.0;
+        for (size_t p = 0; p < m; ++p) {
+            for (size_t q = p + 1; q < m; ++q) {
+                foraDiagonal += matriz[p * m + q] * matriz[p * m + q];
+            }
+        }
+        if (foraDiagonal < 1e-22) break;
+
+        for (size_t p = 0; p < m; ++p) {
+            for (size_t q = p + 1; q < m; ++q) {
+                double apq = matriz[p * m + q];
+                if (fabs(apq) < 1e-300) continue;
+
+                double theta = (matriz[q * m + q] - matriz[p * m + p]) / (2.0 * apq);
+                double t = (theta >= 0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+                double c = 1.0 / sqrt(t * t + 1.0);
+                double s = t * c;
+
+                for (size_t k = 0; k < m; ++k) {
+                    double akp = matriz[k * m + p];
+                    double akq = matriz[k * m + q];
+                    matriz[k * m + p] = c * akp - s * akq;
+                    matriz[k * m + q] = s * akp + c * akq;
+                }
+                for (size_t k = 0; k < m; ++k) {
+                    double apk = matriz[p * m + k];
+                    double aqk = matriz[q * m + k];
+                    matriz[p * m + k] = c * apk - s * aqk;
+                    matriz[q * m + k] = s * apk + c * aqk;
+                }
+                for (size_t k = 0; k < m; ++k) {
+                    double vkp = V[k * m + p];
+                    double vkq = V[k * m + q];
+                    V[k * m + p] = c * vkp - s * vkq;
+                    V[k * m + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    vector<size_t> ordem(m);
+    iota(ordem.begin(), ordem.end(), 0);
+    sort(ordem.begin(), ordem.end(), [&](size_t a, size_t b) { return matriz[a * m + a] > matriz[b * m + b]; });
+
+    valores.resize(m);
+    vetores.resize(m * m);
+    for (size_t c = 0; c < m; ++c) {
+        valores[c] = matriz[ordem[c] * m + ordem[c]];
+        for (size_t k = 0; k < m; ++k) {
+            vetores[c * m + k] = V[k * m + ordem[c]];
+        }
+    }
+}
+
+// Y (n x l) -> Q (n x l') com colunas ortonormais, via autodecomposição da matriz de Gram
+static size_t ortonormalizar(vector<double>& Y, size_t n, size_t l) {
+    vector<double> G = somarPorBloco(n, l * l, [&](size_t inicio, size_t fim, vector<double>& G) {
+        for (size_t i = inicio; i < fim; ++i) {
+            const double* linha = Y.data() + i * l;
+            for (size_t a = 0; a < l; ++a) {
+                for (size_t b = a; b < l; ++b) {
+                    G[a * l + b] += linha[a] * linha[b];
+                }
+            }
+        }
+    });
+    for (size_t a = 0; a < l; ++a) {
+        for (size_t b = 0; b < a; ++b) {
+            G[a * l + b] = G[b * l + a];
+        }
+    }
+
+    vector<double> valores, vetores;
+    autodecomposicao(G, l, valores, vetores);
+
+    size_t mantidas = 0;
+    while (mantidas < l && valores[mantidas] > 1e-12 * valores[0]) {
+        ++mantidas;
+    }
+
+    // Q = Y V diag(1 / sqrt(lambda))
+    vector<double> Q(n * mantidas);
+    paraCadaBloco(n, [&](size_t inicio, size_t fim) {
+        for (size_t i = inicio; i < fim; ++i) {
+            const double* linha = Y.data() + i * l;
+            for (size_t c = 0; c < mantidas; ++c) {
+                double soma = 0.0;
+                for (size_t a = 0; a < l; ++a) {
+                    soma += linha[a] * vetores[c * l + a];
+                }
+                Q[i * mantidas + c] = soma / sqrt(valores[c]);
+            }
+        }
+    });
+
+    Y = move(Q);
+    return mantidas;
+}
+
+// Z = X^T Q (d x l), com X n x d e Q n x l
+static vector<double> transpostaVezes(const vector<double>& X, const vector<double>& Q, size_t n, size_t d, size_t l) {
+    return somarPorBloco(n, d * l, [&](size_t inicio, size_t fim, vector<double>& Z) {
+        for (size_t i = inicio; i < fim; ++i) {
+            const double* linhaX = X.data() + i * d;
+            const double* linhaQ = Q.data() + i * l;
+            for (size_t j = 0; j < d; ++j) {
+                for (size_t c = 0; c < l; ++c) {
+                    Z[j * l + c] += linhaX[j] * linhaQ[c];
+                }
+            }
+        }
+    });
+}
+
+// Y = X Z (n x l), com X n x d e Z d x l
+static vector<double> vezes(const vector<double>& X, const vector<double>& Z, size_t n, size_t d, size_t l) {
+    vector<double> Y(n * l, 0.0);
+    paraCadaBloco(n, [&](size_t inicio, size_t fim) {
+        for (size_t i = inicio; i < fim; ++i) {
+            const double* linhaX = X.data() + i * d;
+            double* linhaY = Y.data() + i * l;
+            for (size_t j = 0; j < d; ++j) {
+                for (size_t c = 0; c < l; ++c) {
+                    linhaY[c] += linhaX[j] * Z[j * l + c];
+                }
+            }
+        }
+    });
+    return Y;
+}
+
+// Getters
+size_t Projecao::getDimOriginal() const {
+    return dimOriginal;
+}
+
+size_t Projecao::getDimReduzida() const {
+    return dimReduzida;
+}
+
+const vector<double>& Projecao::getComponentes() const {
+    return componentes;
+}
+
+double Projecao::getVarianciaRetida() const {
+    return varianciaRetida;
+}
+
+Projecao Projecao::aleatoria(size_t dimOriginal, size_t dimReduzida, uint64_t semente) {
+    Projecao projecao;
+    projecao.dimOriginal = dimOriginal;
+    projecao.dimReduzida = dimReduzida;
+    projecao.media.assign(dimOriginal, 0.0);
+    projecao.componentes.assign(dimReduzida * dimOriginal, 0.0);
+    projecao.varianciaRetida = -1.0;
+
+    GeradorAleatorio gerador(semente, FLUXO_PROJECAO);
+    double escala = sqrt(3.0 / dimReduzida);
+
+    for (double& valor : projecao.componentes) {
+        int sorteio = gerador() % 6;
+        valor = sorteio == 0 ? escala : (sorteio == 1 ? -escala : 0.0);
+    }
+
+    return projecao;
+}
+
+Projecao Projecao::pca(const vector<Instancia>& instancias, size_t dimReduzida, uint64_t semente, int iteracoesPotencia) {
+    if (instancias.empty()) {
+        throw invalid_argument("A base de dados esta vazia.");
+    }
+
+    const size_t n = instancias.size();
+    const size_t d = instancias[0].getAtributos().size();
+    dimReduzida = min(dimReduzida, d);
+    const size_t l = min(d, dimReduzida + 10);
+
+    Projecao projecao;
+    projecao.dimOriginal = d;
+    projecao.dimReduzida = dimReduzida;
+    projecao.media.assign(d, 0.0);
+
+    // Média ponderada e matriz centrada, com cada linha escalada por sqrt(peso)
+    double massa = 0.0;
+    for (const Instancia& instancia : instancias) {
+        const vector<double> atributos = instancia.getAtributos();
+        for (size_t j = 0; j < d; ++j) {
+            projecao.media[j] += instancia.getPeso() * atributos[j];
+        }
+        massa += instancia.getPeso();
+    }
+    for (double& valor : projecao.media) {
+        valor /= massa;
+    }
+
+    vector<double> X(n * d);
+    paraCadaBloco(n, [&](size_t inicio, size_t fim) {
+        for (size_t i = inicio; i < fim; ++i) {
+            const vector<double> atributos = instancias[i].getAtributos();
+            double escala = sqrt(instancias[i].getPeso());
+            for (size_t j = 0; j < d; ++j) {
+                X[i * d + j] = escala * (atributos[j] - projecao.media[j]);
+            }
+        }
+    });
+    double varianciaTotal = inner_product(X.begin(), X.end(), X.begin(), 0.0);
+
+    // Matriz gaussiana de teste por Box-Muller sobre o fluxo da projeção
+    GeradorAleatorio gerador(semente, FLUXO_PROJECAO);
+    vector<double> omega(d * l);
+    for (double& valor : omega) {
+        double u1 = 1.0 - gerador.uniforme();
+        double u2 = gerador.uniforme();
+        valor = sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+    }
+
+    vector<double> Y = vezes(X, omega, n, d, l);
+    size_t colunas = l;
+    for (int iteracao = 0; iteracao < iteracoesPotencia; ++iteracao) {
+        colunas = ortonormalizar(Y, n, colunas);
+        vector<double> Z = transpostaVezes(X, Y, n, d, colunas);
+        Y = vezes(X, Z, n, d, colunas);
+    }
+    colunas = ortonormalizar(Y, n, colunas);
+
+    // B = Q^T X = Z^T; os autovetores de Z^T Z dão os vetores singulares à direita
+    vector<double> Z = transpostaVezes(X, Y, n, d, colunas);
+    vector<double> C(colunas * colunas, 0.0);
+    for (size_t j = 0; j < d; ++j) {
+        for (size_t a = 0; a < colunas; ++a) {
+            for (size_t b = 0; b < colunas; ++b) {
+                C[a * colunas + b] += Z[j * colunas + a] * Z[j * colunas + b];
+            }
+        }
+    }
+
+    vector<double> valores, vetores;
+    autodecomposicao(C, colunas, valores, vetores);
+
+    projecao.dimReduzida = min(dimReduzida, colunas);
+    projecao.componentes.assign(projecao.dimReduzida * d, 0.0);
+    double varianciaCapturada = 0.0;
+    for (size_t c = 0; c < projecao.dimReduzida; ++c) {
+        double escala = 1.0 / sqrt(max(valores[c], 1e-300));
+        for (size_t j = 0; j < d; ++j) {
+            double soma = 0.0;
+            for (size_t a = 0; a < colunas; ++a) {
+                soma += Z[j * colunas + a] * vetores[c * colunas + a];
+            }
+            projecao.componentes[c * d + j] = soma * escala;
+        }
+        varianciaCapturada += valores[c];
+    }
+    projecao.varianciaRetida = varianciaTotal > 0.0 ? varianciaCapturada / varianciaTotal : 1.0;
+
+    return projecao;
+}
+
+vector<double> Projecao::projetar(const vector<double>& atributos) const {
+    vector<double> resultado(dimReduzida, 0.0);
+    for (size_t c = 0; c < dimReduzida; ++c) {
+        const double* componente = componentes.data() + c * dimOriginal;
+        double soma = 0.0;
+        for (size_t j = 0; j < dimOriginal; ++j) {
+            soma += componente[j] * (atributos[j] - media[j]);
+        }
+        resultado[c] = soma;
+    }
+    return resultado;
+}
+
+vector<Instancia> Projecao::aplicar(const vector<Instancia>& instancias) const {
+    vector<Instancia> projetadas(instancias.size(), Instancia(0, {}));
+    paraCadaBloco(instancias.size(), [&](size_t inicio, size_t fim) {
+        for (size_t i = inicio; i < fim; ++i) {
+            projetadas[i] = Instancia(instancias[i].getId(), projetar(instancias[i].getAtributos()), instancias[i].getPeso());
+        }
+    });
+    return projetadas;
+}
+
+Projecao::Distorcao Projecao::medirDistorcao(const vector<Instancia>& originais, const vector<Instancia>& projetadas, uint64_t semente, size_t numPares) const {
+    Distorcao distorcao{0.0, 0.0};
+    if (originais.size() < 2) return distorcao;
+
+    GeradorAleatorio gerador(semente, FLUXO_DISTORCAO);
+    size_t avaliados = 0;
+
+    for (size_t par = 0; par < numPares; ++par) {
+        size_t a = gerador() % originais.size();
+        size_t b = gerador() % originais.size();
+        if (a == b) continue;
+
+        const vector<double> xa = originais[a].getAtributos();
+        const vector<double> xb = originais[b].getAtributos();
+        const vector<double> ya = projetadas[a].getAtributos();
+        const vector<double> yb = projetadas[b].getAtributos();
+
+        double original = 0.0;
+        for (size_t j = 0; j < xa.size(); ++j) {
+            original += (xa[j] - xb[j]) * (xa[j] - xb[j]);
+        }
+        if (original <= 0.0) continue;
+
+        double reduzida = 0.0;
+        for (size_t j = 0; j < ya.size(); ++j) {
+            reduzida += (ya[j] - yb[j]) * (ya[j] - yb[j]);
+        }
+
+        double desvio = fabs(sqrt(reduzida / original) - 1.0);
+        distorcao.media += desvio;
+        distorcao.maxima = max(distorcao.maxima, desvio);
+        ++avaliados;
+    }
+
+    if (avaliados > 0) {
+        distorcao.media /= avaliados;
+    }
+    return distorcao;
+}
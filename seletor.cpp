@@ -0,0 +1,280 @@
+#include "Library/seletor.h"
+#include "Library/numa.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static size_t log2Inteiro(size_t valor) {
+    size_t expoente = 0;
+    while (valor > 1) {
+        valor >>= 1;
+        expoente++;
+    }
+    return expoente;
+}
+
+FormatoTarefa FormatoTarefa::medir(const vector<Instancia>& instancias, size_t K, uint64_t semente) {
+    FormatoTarefa formato;
+    formato.numInstancias = instancias.size();
+    formato.dimensao = instancias.empty() ? 0 : instancias[0].getAtributos().size();
+    formato.numCentroides = K;
+    formato.numCpus = max(1, TopologiaNuma::detectar().getNumCpus());
+
+    // A densidade é medida na mesma amostra da calibração
+    size_t naoNulos = 0, total = 0;
+    for (size_t i : amostrarInstancias(instancias.size(), SeletorBackend::TAMANHO_CALIBRACAO, semente)) {
+        for (double valor : instancias[i].getAtributos()) {
+            naoNulos += valor != 0.0;
+            total++;
+        }
+    }
+    formato.densidade = total > 0 ? static_cast<double>(naoNulos) / total : 1.0;
+    return formato;
+}
+
+string FormatoTarefa::getFaixa() const {
+    ostringstream oss;
+    oss << "n" << log2Inteiro(numInstancias) << "-d" << log2Inteiro(dimensao) << "-k" << log2Inteiro(numCentroides)
+        << "-densidade" << min(9, static_cast<int>(densidade * 10));
+    return oss.str();
+}
+
+void EscolhaBackend::aplicar(ConfiguracaoKmeans& configuracao) const {
+    configuracao.esparso = backend == BACKEND_ESPARSO;
+    configuracao.bitsQuantizacao = backend == BACKEND_QUANTIZADO8 ? 8 : backend == BACKEND_QUANTIZADO16 ? 16 : 0;
+    configuracao.threadsAtribuicao = backend == BACKEND_DENSO ? numThreads : 0;
+}
+
+string EscolhaBackend::nome(BackendAtribuicao backend) {
+    switch (backend) {
+        case BACKEND_ESPARSO: return "esparso";
+        case BACKEND_QUANTIZADO8: return "quantizado8";
+        case BACKEND_QUANTIZADO16: return "quantizado16";
+        default: return "denso";
+    }
+}
+
+static bool backendDeNome(const string& nome, BackendAtribuicao& backend) {
+    for (BackendAtribuicao candidato : {BACKEND_DENSO, BACKEND_ESPARSO, BACKEND_QUANTIZADO8, BACKEND_QUANTIZADO16}) {
+        if (EscolhaBackend::nome(candidato) == nome) {
+            backend = candidato;
+            return true;
+        }
+    }
+    return false;
+}
+
+static string rotulo(const EscolhaBackend& escolha) {
+    string texto = EscolhaBackend::nome(escolha.backend);
+    if (escolha.backend == BACKEND_DENSO && escolha.numThreads > 0) {
+        texto += "/" + to_string(escolha.numThreads);
+    }
+    return texto;
+}
+
+string EscolhaBackend::descrever() const {
+    ostringstream oss;
+    oss << "Backend de atribuicao: " << nome(backend);
+    if (backend == BACKEND_DENSO) {
+        oss << " (threads: " << (numThreads > 0 ? to_string(numThreads) : string("todas")) << ")";
+    }
+    oss << " - " << motivo;
+    // Os backends denso e quantizado dão os rótulos do kernel exato; o esparso usa a forma expandida
+    // ||x||^2 - 2 x.c + ||c||^2, cujo arredondamento pode decidir de outro modo um quase empate
+    if (backend == BACKEND_ESPARSO) {
+        oss << " (os rotulos podem diferir do backend denso em quase empates)";
+    }
+    return oss.str();
+}
+
+// Construtores
+SeletorBackend::SeletorBackend(const string& caminhoPerfil, bool calibrar)
+    : caminhoPerfil(caminhoPerfil), calibrar(calibrar), maquina(identificarMaquina()) {
+    lerPerfil();
+}
+
+string SeletorBackend::identificarMaquina() {
+    string host = "local";
+#ifdef __unix__
+    char nome[256] = {};
+    if (gethostname(nome, sizeof(nome) - 1) == 0 && nome[0] != '\0') {
+        host = nome;
+    }
+#endif
+    return host + "-" + to_string(TopologiaNuma::detectar().getNumCpus()) + "cpus";
+}
+
+void SeletorBackend::lerPerfil() {
+    if (caminhoPerfil.empty()) return;
+
+    // Sem arquivo, o perfil começa vazio; linhas que não seguem o formato são ignoradas
+    ifstream arquivo(caminhoPerfil);
+    string linha;
+    while (getline(arquivo, linha)) {
+        istringstream ss(linha);
+        string maquinaLinha, faixa, nomeBackend;
+        EscolhaBackend escolha;
+        if (!(ss >> maquinaLinha >> faixa >> nomeBackend >> escolha.numThreads >> escolha.microsPorPassada) ||
+            !backendDeNome(nomeBackend, escolha.backend)) {
+            continue;
+        }
+        decisoes[maquinaLinha + " " + faixa] = escolha;
+    }
+}
+
+void SeletorBackend::gravarPerfil() const {
+    const string temporario = caminhoPerfil + ".tmp";
+    ofstream arquivo(temporario);
+
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir o arquivo para escrita: " << temporario << endl;
+        return;
+    }
+
+    for (const auto& [chave, escolha] : decisoes) {
+        arquivo << chave << " " << EscolhaBackend::nome(escolha.backend) << " " << escolha.numThreads << " "
+                << escolha.microsPorPassada << "\n";
+    }
+    arquivo.close();
+
+    if (!arquivo || rename(temporario.c_str(), caminhoPerfil.c_str()) != 0) {
+        cerr << "Erro ao gravar o perfil de backends: " << caminhoPerfil << endl;
+        remove(temporario.c_str());
+    }
+}
+
+EscolhaBackend SeletorBackend::aplicarRegras(const FormatoTarefa& formato) {
+    EscolhaBackend escolha;
+    ostringstream motivo;
+
+    if (formato.densidade < 0.25) {
+        escolha.backend = BACKEND_ESPARSO;
+        motivo << "regra: densidade " << setprecision(2) << formato.densidade << " abaixo de 0.25";
+    } else if (formato.dimensao >= 64 && formato.numInstancias * formato.numCentroides >= 1000000) {
+        // Com d alto, a estimativa inteira poupa banda e poucas instâncias são reverificadas
+        escolha.backend = BACKEND_QUANTIZADO8;
+        motivo << "regra: d = " << formato.dimensao << " e n*K = " << formato.numInstancias * formato.numCentroides;
+    } else {
+        // Partições de pelo menos 1024 instâncias, para que o custo de criar as threads se pague
+        escolha.numThreads = max<size_t>(1, min(formato.numCpus, formato.numInstancias / 1024));
+        motivo << "regra: base densa, " << escolha.numThreads << " particoes de ate "
+               << (formato.numInstancias + escolha.numThreads - 1) / escolha.numThreads << " instancias";
+    }
+    escolha.motivo = motivo.str();
+    return escolha;
+}
+
+EscolhaBackend SeletorBackend::calibrarAmostra(const vector<Instancia>& instancias, const FormatoTarefa& formato, uint64_t semente) const {
+    vector<Instancia> amostra;
+    for (size_t i : amostrarInstancias(instancias.size(), TAMANHO_CALIBRACAO, semente)) {
+        amostra.push_back(instancias[i]);
+    }
+
+    // Centroides nas primeiras instâncias da amostra, que já está em ordem aleatória
+    size_t K = min(formato.numCentroides, amostra.size());
+    vector<size_t> primeiras(K);
+    for (size_t i = 0; i < K; ++i) {
+        primeiras[i] = i;
+    }
+    vector<Centroide> centroides = criarCentroidesDaAmostra(amostra, primeiras);
+
+    vector<EscolhaBackend> candidatos;
+    vector<size_t> contagensThreads = {1, formato.numCpus / 2, formato.numCpus};
+    for (size_t numThreads : contagensThreads) {
+        if (numThreads == 0 || (!candidatos.empty() && candidatos.back().numThreads == numThreads)) continue;
+        EscolhaBackend candidato;
+        candidato.numThreads = numThreads;
+        candidatos.push_back(candidato);
+    }
+    if (formato.densidade <= 0.5) {
+        EscolhaBackend candidato;
+        candidato.backend = BACKEND_ESPARSO;
+        candidatos.push_back(candidato);
+    }
+    // Em dimensão baixa a quantização não tem o que poupar
+    if (formato.dimensao >= 16) {
+        for (BackendAtribuicao backend : {BACKEND_QUANTIZADO8, BACKEND_QUANTIZADO16}) {
+            EscolhaBackend candidato;
+            candidato.backend = backend;
+            candidatos.push_back(candidato);
+        }
+    }
+
+    // Custo de cada candidato: a melhor de algumas passadas, depois de uma de aquecimento, somada
+    // à montagem do backend amortizada nas iterações
+    ostringstream motivo;
+    motivo << "calibrado em " << amostra.size() << " instancias:";
+    EscolhaBackend melhor;
+    melhor.microsPorPassada = numeric_limits<double>::infinity();
+    for (EscolhaBackend& candidato : candidatos) {
+        ConfiguracaoKmeans configuracao;
+        candidato.aplicar(configuracao);
+
+        auto inicio = chrono::steady_clock::now();
+        unique_ptr<DadosAtribuicao> dados = criarDadosAtribuicao(amostra, configuracao);
+        double montagem = chrono::duration<double, micro>(chrono::steady_clock::now() - inicio).count();
+
+        Atribuicao atribuicao;
+        dados->atribuir(centroides, atribuicao);
+        double passada = numeric_limits<double>::infinity();
+        for (int r = 0; r < PASSADAS_CALIBRACAO; ++r) {
+            inicio = chrono::steady_clock::now();
+            dados->atribuir(centroides, atribuicao);
+            passada = min(passada, chrono::duration<double, micro>(chrono::steady_clock::now() - inicio).count());
+        }
+
+        candidato.microsPorPassada = passada + montagem / ITERACOES_AMORTIZACAO;
+        motivo << (&candidato == &candidatos.front() ? " " : ", ") << rotulo(candidato) << " " << fixed << setprecision(3) << candidato.microsPorPassada / 1000.0 << " ms";
+        if (candidato.microsPorPassada < melhor.microsPorPassada) {
+            melhor = candidato;
+        }
+    }
+
+    melhor.motivo = motivo.str();
+    return melhor;
+}
+
+EscolhaBackend SeletorBackend::escolher(const vector<Instancia>& instancias, size_t K, uint64_t semente) {
+    FormatoTarefa formato = FormatoTarefa::medir(instancias, K, semente);
+    const string chave = maquina + " " + formato.getFaixa();
+
+    // Uma decisão com mais threads do que as CPUs disponíveis agora (perfil copiado de outra máquina
+    // com o mesmo nome, processo restrito a menos CPUs) é descartada em vez de aplicada
+    string descartada;
+    auto decisao = decisoes.find(chave);
+    if (decisao != decisoes.end()) {
+        EscolhaBackend escolha = decisao->second;
+        if (escolha.numThreads <= formato.numCpus) {
+            escolha.motivo = "perfil da maquina " + maquina + " para a faixa " + formato.getFaixa();
+            return escolha;
+        }
+        descartada = "perfil descartado (" + to_string(escolha.numThreads) + " threads para " + to_string(formato.numCpus) + " CPUs); ";
+    }
+
+    if (!calibrar || instancias.empty()) {
+        EscolhaBackend escolha = aplicarRegras(formato);
+        escolha.motivo = descartada + escolha.motivo;
+        return escolha;
+    }
+
+    // Só decisões calibradas vão para o perfil; as regras são recalculadas a cada execução
+    EscolhaBackend escolha = calibrarAmostra(instancias, formato, semente);
+    if (!caminhoPerfil.empty()) {
+        decisoes[chave] = escolha;
+        gravarPerfil();
+    }
+    escolha.motivo = descartada + escolha.motivo;
+    return escolha;
+}
@@ -0,0 +1,410 @@
+#include "Library/servidor.h"
+#include <filesystem>
+#include <algorithm>
+#include <stdexcept>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#define K_MEANS_SERVIDOR_POSIX
+#endif
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const size_t AMOSTRAS_LATENCIA = 8192;
+static const uint32_t DIMENSAO_INCOMPATIVEL = 0xFFFFFFFF;
+static const uint32_t PEDIDO_MUITO_GRANDE = 0xFFFFFFFE;
+
+// Construtores
+ServidorAtribuicao::ServidorAtribuicao(const string& caminhoModelo, const string& caminhoSocket, int porta)
+    : caminhoModelo(caminhoModelo), caminhoSocket(caminhoSocket), porta(porta), descritorEscuta(-1),
+      executando(false), proximoCliente(0), proximaLatencia(0), numPedidos(0) {
+    modelo = make_shared<const Modelo>(Modelo::carregar(caminhoModelo));
+}
+
+ServidorAtribuicao::~ServidorAtribuicao() {
+    parar();
+}
+
+#ifdef K_MEANS_SERVIDOR_POSIX
+
+static bool lerTudo(int descritor, void* destino, size_t tamanho) {
+    char* atual = static_cast<char*>(destino);
+    while (tamanho > 0) {
+        ssize_t lidos = read(descritor, atual, tamanho);
+        if (lidos <= 0) return false;
+        atual += lidos;
+        tamanho -= lidos;
+    }
+    return true;
+}
+
+// Lê e descarta tamanho bytes sem alocá-los de uma vez
+static bool descartar(int descritor, uint64_t tamanho) {
+    char buffer[65536];
+    while (tamanho > 0) {
+        size_t parte = min<uint64_t>(tamanho, sizeof(buffer));
+        if (!lerTudo(descritor, buffer, parte)) return false;
+        tamanho -= parte;
+    }
+    return true;
+}
+
+// O caminho só é removido se for um socket, nunca um arquivo comum que calhe de ter o mesmo nome
+static void removerSocket(const string& caminho) {
+    error_code erro;
+    if (fs::is_socket(fs::symlink_status(caminho, erro))) {
+        unlink(caminho.c_str());
+    }
+}
+
+// Sem MSG_NOSIGNAL (macOS), o SIGPIPE é desligado por socket com SO_NOSIGPIPE ao aceitar o cliente
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Um cliente que fecha a conexão antes da resposta gera EPIPE, e não um SIGPIPE que derrubaria o servidor
+static bool escreverTudo(int descritor, const void* origem, size_t tamanho) {
+    const char* atual = static_cast<const char*>(origem);
+    while (tamanho > 0) {
+        ssize_t escritos = send(descritor, atual, tamanho, MSG_NOSIGNAL);
+        if (escritos <= 0) return false;
+        atual += escritos;
+        tamanho -= escritos;
+    }
+    return true;
+}
+
+void ServidorAtribuicao::fecharEscuta() {
+    if (descritorEscuta >= 0) {
+        close(descritorEscuta);
+        descritorEscuta = -1;
+    }
+}
+
+void ServidorAtribuicao::executar() {
+    if (!caminhoSocket.empty()) {
+        descritorEscuta = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (descritorEscuta < 0) {
+            throw runtime_error("Erro ao criar o socket: " + caminhoSocket);
+        }
+        sockaddr_un endereco{};
+        endereco.sun_family = AF_UNIX;
+        if (caminhoSocket.size() >= sizeof(endereco.sun_path)) {
+            fecharEscuta();
+            throw invalid_argument("Caminho do socket muito longo: " + caminhoSocket);
+        }
+        strcpy(endereco.sun_path, caminhoSocket.c_str());
+        removerSocket(caminhoSocket);
+        if (bind(descritorEscuta, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) != 0) {
+            fecharEscuta();
+            throw runtime_error("Erro ao associar o socket: " + caminhoSocket);
+        }
+    } else {
+        descritorEscuta = socket(AF_INET, SOCK_STREAM, 0);
+        if (descritorEscuta < 0) {
+            throw runtime_error("Erro ao criar o socket na porta: " + to_string(porta));
+        }
+        int reutilizar = 1;
+        setsockopt(descritorEscuta, SOL_SOCKET, SO_REUSEADDR, &reutilizar, sizeof(reutilizar));
+        sockaddr_in endereco{};
+        endereco.sin_family = AF_INET;
+        endereco.sin_port = htons(porta);
+        endereco.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(descritorEscuta, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) != 0) {
+            fecharEscuta();
+            throw runtime_error("Erro ao associar a porta: " + to_string(porta));
+        }
+    }
+
+    if (listen(descritorEscuta, 128) != 0) {
+        fecharEscuta();
+        throw runtime_error("Erro ao escutar conexoes.");
+    }
+
+    executando = true;
+    thread lotes(&ServidorAtribuicao::processarLotes, this);
+    thread monitor(&ServidorAtribuicao::monitorarModelo, this);
+
+    while (executando) {
+        int cliente = accept(descritorEscuta, nullptr, nullptr);
+        if (cliente < 0) {
+            if (!executando) break;
+            continue;
+        }
+
+        if (caminhoSocket.empty()) {
+            int semAtraso = 1;
+            setsockopt(cliente, IPPROTO_TCP, TCP_NODELAY, &semAtraso, sizeof(semAtraso));
+        }
+#ifdef SO_NOSIGPIPE
+        int semSinal = 1;
+        setsockopt(cliente, SOL_SOCKET, SO_NOSIGPIPE, &semSinal, sizeof(semSinal));
+#endif
+
+        unirClientesEncerrados();
+        lock_guard<mutex> lock(mutexClientes);
+        uint64_t id = proximoCliente++;
+        descritoresClientes.insert(cliente);
+        threadsClientes.emplace(id, thread(&ServidorAtribuicao::atenderCliente, this, id, cliente));
+    }
+
+    condicaoFila.notify_all();
+    lotes.join();
+    monitor.join();
+
+    // Os clientes ainda conectados saem do read com o shutdown e fecham os próprios descritores
+    map<uint64_t, thread> restantes;
+    {
+        lock_guard<mutex> lock(mutexClientes);
+        for (int cliente : descritoresClientes) {
+            shutdown(cliente, SHUT_RDWR);
+        }
+        restantes.swap(threadsClientes);
+        clientesEncerrados.clear();
+    }
+    for (auto& [id, t] : restantes) {
+        t.join();
+    }
+
+    fecharEscuta();
+    if (!caminhoSocket.empty()) {
+        removerSocket(caminhoSocket);
+    }
+}
+
+void ServidorAtribuicao::unirClientesEncerrados() {
+    vector<thread> encerradas;
+    {
+        lock_guard<mutex> lock(mutexClientes);
+        for (uint64_t id : clientesEncerrados) {
+            auto cliente = threadsClientes.find(id);
+            if (cliente != threadsClientes.end()) {
+                encerradas.push_back(move(cliente->second));
+                threadsClientes.erase(cliente);
+            }
+        }
+        clientesEncerrados.clear();
+    }
+    // A thread já saiu de atenderCliente; o join só espera o fim da sua execução
+    for (thread& t : encerradas) {
+        t.join();
+    }
+}
+
+void ServidorAtribuicao::parar() {
+    if (!executando.exchange(false)) return;
+    if (descritorEscuta >= 0) {
+        shutdown(descritorEscuta, SHUT_RDWR);
+    }
+    condicaoFila.notify_all();
+    condicaoMonitor.notify_all();
+}
+
+void ServidorAtribuicao::atenderCliente(uint64_t id, int descritor) {
+    // Um cliente com erro encerra apenas a própria conexão
+    try {
+        atenderPedidos(descritor);
+    } catch (const exception& e) {
+        cerr << "Erro ao atender o cliente: " << e.what() << endl;
+    }
+
+    lock_guard<mutex> lock(mutexClientes);
+    descritoresClientes.erase(descritor);
+    close(descritor);
+    clientesEncerrados.push_back(id);
+}
+
+void ServidorAtribuicao::atenderPedidos(int descritor) {
+    while (executando) {
+        uint32_t cabecalho[2];
+        if (!lerTudo(descritor, cabecalho, sizeof(cabecalho))) break;
+
+        auto chegada = chrono::steady_clock::now();
+
+        if (cabecalho[0] == 0 && cabecalho[1] == 0) {
+            uint64_t pedidos = getNumPedidos();
+            double p50 = getLatenciaPercentil(50);
+            double p99 = getLatenciaPercentil(99);
+            if (!escreverTudo(descritor, &pedidos, sizeof(pedidos)) ||
+                !escreverTudo(descritor, &p50, sizeof(p50)) ||
+                !escreverTudo(descritor, &p99, sizeof(p99))) break;
+            continue;
+        }
+
+        // O cabeçalho vem do cliente: o tamanho é limitado antes de qualquer alocação e, se não
+        // for possível descartar o corpo com segurança, a conexão é encerrada
+        const uint64_t numValores = static_cast<uint64_t>(cabecalho[0]) * cabecalho[1];
+        if (cabecalho[0] > MAX_PONTOS_POR_PEDIDO || numValores > MAX_VALORES_POR_PEDIDO) {
+            escreverTudo(descritor, &PEDIDO_MUITO_GRANDE, sizeof(PEDIDO_MUITO_GRANDE));
+            break;
+        }
+        if (cabecalho[1] != atomic_load(&modelo)->getDimensao()) {
+            if (!descartar(descritor, numValores * sizeof(double)) ||
+                !escreverTudo(descritor, &DIMENSAO_INCOMPATIVEL, sizeof(DIMENSAO_INCOMPATIVEL))) break;
+            continue;
+        }
+
+        auto pedido = make_shared<Pedido>();
+        pedido->numPontos = cabecalho[0];
+        pedido->dimensao = cabecalho[1];
+        pedido->pontos.resize(pedido->numPontos * pedido->dimensao);
+        if (!lerTudo(descritor, pedido->pontos.data(), pedido->pontos.size() * sizeof(double))) break;
+
+        future<vector<int>> resultado = pedido->resultado.get_future();
+        {
+            // Verificado sob o mutex da fila para não enfileirar depois que o lote final terminou
+            lock_guard<mutex> lock(mutexFila);
+            if (!executando) break;
+            fila.push_back(pedido);
+        }
+        condicaoFila.notify_one();
+
+        vector<int> rotulos = resultado.get();
+        bool enviado;
+        if (rotulos.size() != pedido->numPontos) {
+            enviado = escreverTudo(descritor, &DIMENSAO_INCOMPATIVEL, sizeof(DIMENSAO_INCOMPATIVEL));
+        } else {
+            uint32_t numPontos = rotulos.size();
+            vector<int32_t> resposta(rotulos.begin(), rotulos.end());
+            enviado = escreverTudo(descritor, &numPontos, sizeof(numPontos)) &&
+                      escreverTudo(descritor, resposta.data(), resposta.size() * sizeof(int32_t));
+        }
+        if (!enviado) break;
+
+        registrarLatencia(chrono::duration<double, micro>(chrono::steady_clock::now() - chegada).count());
+    }
+}
+
+#else
+
+void ServidorAtribuicao::executar() {
+    throw runtime_error("O servidor de atribuicao requer sockets POSIX.");
+}
+
+void ServidorAtribuicao::parar() {
+    executando = false;
+}
+
+void ServidorAtribuicao::atenderCliente(uint64_t id, int descritor) {}
+
+void ServidorAtribuicao::atenderPedidos(int descritor) {}
+
+void ServidorAtribuicao::unirClientesEncerrados() {}
+
+void ServidorAtribuicao::fecharEscuta() {}
+
+#endif
+
+// Agrupa todos os pedidos que chegaram enquanto o lote anterior era processado
+void ServidorAtribuicao::processarLotes() {
+    while (true) {
+        deque<shared_ptr<Pedido>> lote;
+        {
+            unique_lock<mutex> lock(mutexFila);
+            condicaoFila.wait(lock, [&]() { return !fila.empty() || !executando; });
+            if (fila.empty() && !executando) break;
+            lote.swap(fila);
+        }
+
+        shared_ptr<const Modelo> atual = atomic_load(&modelo);
+        size_t dimensao = atual->getDimensao();
+
+        vector<double> pontos;
+        size_t numPontos = 0;
+        for (const auto& pedido : lote) {
+            if (pedido->dimensao == dimensao) {
+                numPontos += pedido->numPontos;
+            }
+        }
+        pontos.reserve(numPontos * dimensao);
+        for (const auto& pedido : lote) {
+            if (pedido->dimensao == dimensao) {
+                pontos.insert(pontos.end(), pedido->pontos.begin(), pedido->pontos.end());
+            }
+        }
+
+        // Uma falha no lote é repassada aos pedidos dele, cujos clientes encerram a conexão; o
+        // servidor continua atendendo os demais
+        vector<int> rotulos;
+        try {
+            rotulos = atual->predizer(pontos.data(), numPontos);
+        } catch (...) {
+            for (auto& pedido : lote) {
+                pedido->resultado.set_exception(current_exception());
+            }
+            continue;
+        }
+
+        size_t deslocamento = 0;
+        for (auto& pedido : lote) {
+            if (pedido->dimensao != dimensao) {
+                pedido->resultado.set_value({});
+                continue;
+            }
+            pedido->resultado.set_value(vector<int>(rotulos.begin() + deslocamento, rotulos.begin() + deslocamento + pedido->numPontos));
+            deslocamento += pedido->numPontos;
+        }
+    }
+}
+
+// Recarrega o modelo quando o arquivo muda e troca o ponteiro atomicamente
+void ServidorAtribuicao::monitorarModelo() {
+    error_code erro;
+    auto ultimaModificacao = fs::last_write_time(caminhoModelo, erro);
+
+    while (executando) {
+        {
+            unique_lock<mutex> lock(mutexMonitor);
+            condicaoMonitor.wait_for(lock, chrono::milliseconds(200), [&]() { return !executando; });
+        }
+        if (!executando) break;
+
+        auto modificacao = fs::last_write_time(caminhoModelo, erro);
+        if (erro || modificacao == ultimaModificacao) continue;
+
+        try {
+            auto novo = make_shared<const Modelo>(Modelo::carregar(caminhoModelo));
+            atomic_store(&modelo, shared_ptr<const Modelo>(novo));
+            ultimaModificacao = modificacao;
+            cout << "Modelo recarregado: " << caminhoModelo << endl;
+        } catch (const exception& e) {
+            // Arquivo ainda sendo escrito; tenta de novo na próxima verificação
+        }
+    }
+}
+
+void ServidorAtribuicao::registrarLatencia(double microssegundos) {
+    lock_guard<mutex> lock(mutexLatencias);
+    if (latencias.size() < AMOSTRAS_LATENCIA) {
+        latencias.push_back(microssegundos);
+    } else {
+        latencias[proximaLatencia] = microssegundos;
+    }
+    proximaLatencia = (proximaLatencia + 1) % AMOSTRAS_LATENCIA;
+    numPedidos++;
+}
+
+double ServidorAtribuicao::getLatenciaPercentil(double percentil) {
+    vector<double> copia;
+    {
+        lock_guard<mutex> lock(mutexLatencias);
+        copia = latencias;
+    }
+    if (copia.empty()) return 0.0;
+
+    size_t posicao = min(copia.size() - 1, (size_t) (percentil / 100.0 * copia.size()));
+    nth_element(copia.begin(), copia.begin() + posicao, copia.end());
+    return copia[posicao];
+}
+
+uint64_t ServidorAtribuicao::getNumPedidos() {
+    lock_guard<mutex> lock(mutexLatencias);
+    return numPedidos;
+}
@@ -0,0 +1,110 @@
+#include "Library/sintetico.h"
+#include "Library/aleatorio.h"
+#include <future>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <iterator>
+
+using namespace std;
+
+// Normal padrão por Box-Muller sobre o gerador de contador
+static double normal(GeradorAleatorio& gerador) {
+    double u1 = 1.0 - gerador.uniforme();
+    double u2 = gerador.uniforme();
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+// Construtores
+GeradorBlobs::GeradorBlobs(const ParametrosBlobs& parametros) : parametros(parametros) {
+    if (parametros.numClusters <= 0 || parametros.dimensao == 0) {
+        throw invalid_argument("A base sintetica precisa de ao menos um cluster e um atributo.");
+    }
+    const size_t K = parametros.numClusters;
+    const size_t d = parametros.dimensao;
+
+    // O fluxo 0 da família sorteia os centros; a instância i usa o fluxo i + 1
+    GeradorAleatorio gerador(parametros.semente, FLUXO_SINTETICO);
+    centros.resize(K * d);
+    for (double& coordenada : centros) {
+        coordenada = parametros.separacao * normal(gerador);
+    }
+
+    pesosAcumulados.resize(K);
+    double total = 0.0;
+    for (size_t k = 0; k < K; ++k) {
+        total += pow(k + 1.0, -parametros.desequilibrio);
+        pesosAcumulados[k] = total;
+    }
+    for (double& peso : pesosAcumulados) {
+        peso /= total;
+    }
+}
+
+// Getters
+const ParametrosBlobs& GeradorBlobs::getParametros() const {
+    return parametros;
+}
+
+const vector<double>& GeradorBlobs::getCentros() const {
+    return centros;
+}
+
+int GeradorBlobs::clusterDe(size_t i) const {
+    double u = GeradorAleatorio::uniforme(parametros.semente, FLUXO_SINTETICO + 1 + i, 0);
+    size_t k = upper_bound(pesosAcumulados.begin(), pesosAcumulados.end(), u) - pesosAcumulados.begin();
+    return min(k, pesosAcumulados.size() - 1);
+}
+
+Instancia GeradorBlobs::gerarInstancia(size_t i) const {
+    const size_t d = parametros.dimensao;
+    const double* centro = centros.data() + clusterDe(i) * d;
+
+    // O primeiro número do fluxo escolheu o cluster
+    GeradorAleatorio gerador(parametros.semente, FLUXO_SINTETICO + 1 + i);
+    gerador();
+
+    vector<double> atributos(d);
+    for (size_t j = 0; j < d; ++j) {
+        atributos[j] = centro[j] + normal(gerador);
+    }
+    return Instancia(i, move(atributos));
+}
+
+void GeradorBlobs::gerar(const function<void(size_t, vector<Instancia>&)>& consumidor, size_t tamanhoBloco) const {
+    const size_t n = parametros.numInstancias;
+    size_t numThreads = max(1u, thread::hardware_concurrency());
+    tamanhoBloco = max<size_t>(tamanhoBloco, 1);
+
+    for (size_t inicioLote = 0; inicioLote < n; inicioLote += numThreads * tamanhoBloco) {
+        vector<future<vector<Instancia>>> futures;
+        for (size_t t = 0; t < numThreads; ++t) {
+            size_t inicio = inicioLote + t * tamanhoBloco;
+            if (inicio >= n) break;
+            size_t fim = min(inicio + tamanhoBloco, n);
+            futures.push_back(async(launch::async, [this, inicio, fim]() {
+                vector<Instancia> bloco;
+                bloco.reserve(fim - inicio);
+                for (size_t i = inicio; i < fim; ++i) {
+                    bloco.push_back(gerarInstancia(i));
+                }
+                return bloco;
+            }));
+        }
+
+        for (size_t t = 0; t < futures.size(); ++t) {
+            vector<Instancia> bloco = futures[t].get();
+            consumidor(inicioLote + t * tamanhoBloco, bloco);
+        }
+    }
+}
+
+vector<Instancia> GeradorBlobs::gerarTodas() const {
+    vector<Instancia> instancias;
+    instancias.reserve(parametros.numInstancias);
+    gerar([&](size_t, vector<Instancia>& bloco) {
+        instancias.insert(instancias.end(), make_move_iterator(bloco.begin()), make_move_iterator(bloco.end()));
+    });
+    return instancias;
+}
@@ -0,0 +1,159 @@
+#include "Library/soma.h"
+#include <map>
+#include <stdexcept>
+
+using namespace std;
+
+// O nó (nivel, indice) cobre todos os blocos quando é o primeiro do nível e o nível alcança numBlocos
+static bool ehRaiz(size_t nivel, size_t indice, size_t numBlocos) {
+    return indice == 0 && (size_t(1) << nivel) >= numBlocos;
+}
+
+// O irmão à direita só contém blocos além do último: o nó sobe de nível sem somas
+static bool irmaoVazio(size_t nivel, size_t indice, size_t numBlocos) {
+    return indice % 2 == 0 && ((indice + 1) << nivel) >= numBlocos;
+}
+
+static void somarEm(vector<double>& esquerda, const vector<double>& direita) {
+    for (size_t i = 0; i < esquerda.size(); ++i) {
+        esquerda[i] += direita[i];
+    }
+}
+
+// Soma direita em esquerda, nó denso ou esparso; o resultado só é denso se uma das partes for
+static void somarEm(SomaEmArvore::No& esquerda, const SomaEmArvore::No& direita) {
+    if (!esquerda.esparso && !direita.esparso) {
+        somarEm(esquerda.valores, direita.valores);
+    } else if (!esquerda.esparso) {
+        for (size_t e = 0; e < direita.indices.size(); ++e) {
+            esquerda.valores[direita.indices[e]] += direita.valores[e];
+        }
+    } else if (!direita.esparso) {
+        vector<double> valores = direita.valores;
+        for (size_t e = 0; e < esquerda.indices.size(); ++e) {
+            valores[esquerda.indices[e]] = esquerda.valores[e] + valores[esquerda.indices[e]];
+        }
+        esquerda.valores = move(valores);
+        esquerda.indices.clear();
+        esquerda.esparso = false;
+    } else {
+        // Intercalação das duas listas ordenadas
+        vector<size_t> indices;
+        vector<double> valores;
+        indices.reserve(esquerda.indices.size() + direita.indices.size());
+        valores.reserve(esquerda.indices.size() + direita.indices.size());
+        size_t a = 0, b = 0;
+        while (a < esquerda.indices.size() || b < direita.indices.size()) {
+            if (b == direita.indices.size() || (a < esquerda.indices.size() && esquerda.indices[a] < direita.indices[b])) {
+                indices.push_back(esquerda.indices[a]);
+                valores.push_back(esquerda.valores[a++]);
+            } else if (a == esquerda.indices.size() || direita.indices[b] < esquerda.indices[a]) {
+                indices.push_back(direita.indices[b]);
+                valores.push_back(direita.valores[b++]);
+            } else {
+                indices.push_back(esquerda.indices[a]);
+                valores.push_back(esquerda.valores[a++] + direita.valores[b++]);
+            }
+        }
+        esquerda.indices = move(indices);
+        esquerda.valores = move(valores);
+    }
+}
+
+static vector<double> densificar(SomaEmArvore::No& no, size_t tamanho) {
+    if (!no.esparso) {
+        return move(no.valores);
+    }
+    vector<double> valores(tamanho, 0.0);
+    for (size_t e = 0; e < no.indices.size(); ++e) {
+        valores[no.indices[e]] = no.valores[e];
+    }
+    return valores;
+}
+
+SomaEmArvore::Pilha::Pilha(size_t numBlocos) : numBlocos(numBlocos) {}
+
+void SomaEmArvore::Pilha::adicionar(size_t bloco, vector<double> valores) {
+    nos.push_back({0, bloco, move(valores), false, {}});
+    subir();
+}
+
+void SomaEmArvore::Pilha::adicionarEsparso(size_t bloco, vector<size_t> indices, vector<double> valores) {
+    nos.push_back({0, bloco, move(valores), true, move(indices)});
+    subir();
+}
+
+void SomaEmArvore::Pilha::subir() {
+
+    while (true) {
+        No& topo = nos.back();
+        if (ehRaiz(topo.nivel, topo.indice, numBlocos)) break;
+
+        if (topo.indice % 2 == 1 && nos.size() >= 2) {
+            No& anterior = nos[nos.size() - 2];
+            if (anterior.nivel == topo.nivel && anterior.indice + 1 == topo.indice) {
+                somarEm(anterior, topo);
+                anterior.nivel++;
+                anterior.indice /= 2;
+                nos.pop_back();
+                continue;
+            }
+        }
+
+        if (irmaoVazio(topo.nivel, topo.indice, numBlocos)) {
+            topo.nivel++;
+            topo.indice /= 2;
+            continue;
+        }
+        break;
+    }
+}
+
+vector<SomaEmArvore::No>& SomaEmArvore::Pilha::getNos() {
+    return nos;
+}
+
+size_t SomaEmArvore::numBlocos(size_t numInstancias) {
+    return (numInstancias + TAMANHO_BLOCO - 1) / TAMANHO_BLOCO;
+}
+
+vector<double> SomaEmArvore::combinar(vector<No> nos, size_t numBlocos, size_t tamanho) {
+    if (nos.empty()) {
+        return vector<double>(tamanho, 0.0);
+    }
+
+    map<pair<size_t, size_t>, No> arvore;
+    for (auto& no : nos) {
+        arvore[{no.nivel, no.indice}] = move(no);
+    }
+
+    for (size_t nivel = 0; ; ++nivel) {
+        if (arvore.size() == 1 && ehRaiz(arvore.begin()->first.first, arvore.begin()->first.second, numBlocos)) {
+            return densificar(arvore.begin()->second, tamanho);
+        }
+
+        auto it = arvore.lower_bound({nivel, 0});
+        while (it != arvore.end() && it->first.first == nivel) {
+            size_t indice = it->first.second;
+            auto irmao = arvore.find({nivel, indice + 1});
+
+            if (indice % 2 == 0 && irmao != arvore.end()) {
+                No no = move(it->second);
+                somarEm(no, irmao->second);
+                arvore.erase(irmao);
+                it = arvore.erase(it);
+                arvore[{nivel + 1, indice / 2}] = move(no);
+            } else if (irmaoVazio(nivel, indice, numBlocos)) {
+                No no = move(it->second);
+                it = arvore.erase(it);
+                arvore[{nivel + 1, indice / 2}] = move(no);
+            } else {
+                throw logic_error("Soma em arvore com blocos faltando.");
+            }
+        }
+
+        if (arvore.empty() || nivel > 64) {
+            throw logic_error("Soma em arvore sem raiz.");
+        }
+    }
+}
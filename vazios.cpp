@@ -0,0 +1,158 @@
+#include "Library/vazios.h"
+#include "Library/aleatorio.h"
+
+using namespace std;
+
+// Move a instância i para o cluster destino, corrigindo somas, contagens e massas dos dois clusters,
+// a distância da instância ao novo centroide e a inércia
+static void moverInstancia(size_t i, int destino, const Instancia& instancia, double novaDistancia, Atribuicao& atribuicao) {
+    const vector<double> atributos = instancia.getAtributos();
+    const size_t d = atributos.size();
+    const int origem = atribuicao.rotulos[i];
+    const double peso = instancia.getPeso();
+
+    for (size_t j = 0; j < d; ++j) {
+        atribuicao.somas[origem * d + j] -= peso * atributos[j];
+        atribuicao.somas[destino * d + j] += peso * atributos[j];
+    }
+    atribuicao.contagens[origem]--;
+    atribuicao.contagens[destino]++;
+    atribuicao.massas[origem] -= peso;
+    atribuicao.massas[destino] += peso;
+    atribuicao.rotulos[i] = destino;
+    atribuicao.mudancas++;
+    atribuicao.inercia += peso * (novaDistancia - atribuicao.distancias[i]);
+    atribuicao.distancias[i] = novaDistancia;
+}
+
+// O centroide reparado passa a ser a média ponderada dos membros que recebeu
+static void posicionarCentroide(Centroide& centroide, int k, const Atribuicao& atribuicao, size_t d) {
+    vector<double> media(atribuicao.somas.begin() + k * d, atribuicao.somas.begin() + (k + 1) * d);
+    for (double& valor : media) {
+        valor /= atribuicao.massas[k];
+    }
+    centroide.setAtributos(media);
+}
+
+// Instância mais distante do seu centroide entre as que podem sair sem esvaziar o próprio cluster
+static long instanciaMaisDistante(const Atribuicao& atribuicao) {
+    long escolhida = -1;
+    for (size_t i = 0; i < atribuicao.rotulos.size(); ++i) {
+        if (atribuicao.contagens[atribuicao.rotulos[i]] < 2) continue;
+        if (escolhida == -1 || atribuicao.distancias[i] > atribuicao.distancias[escolhida]) {
+            escolhida = i;
+        }
+    }
+    return escolhida;
+}
+
+// Sorteio D²: probabilidade proporcional a peso * distância ao centroide atual
+static long instanciaSorteada(const vector<Instancia>& instancias, const Atribuicao& atribuicao, GeradorAleatorio& gerador) {
+    double total = 0.0;
+    for (size_t i = 0; i < atribuicao.rotulos.size(); ++i) {
+        if (atribuicao.contagens[atribuicao.rotulos[i]] < 2) continue;
+        total += instancias[i].getPeso() * atribuicao.distancias[i];
+    }
+    if (total <= 0.0) {
+        return instanciaMaisDistante(atribuicao);
+    }
+
+    double alvo = gerador.uniforme() * total;
+    long ultima = -1;
+    for (size_t i = 0; i < atribuicao.rotulos.size(); ++i) {
+        if (atribuicao.contagens[atribuicao.rotulos[i]] < 2) continue;
+        ultima = i;
+        alvo -= instancias[i].getPeso() * atribuicao.distancias[i];
+        if (alvo < 0.0) break;
+    }
+    return ultima;
+}
+
+// Divide o cluster de maior SSE entre o seu centroide e o seu membro mais distante
+static bool dividirMaiorSse(int vazio, const vector<Instancia>& instancias, Atribuicao& atribuicao) {
+    const size_t K = atribuicao.contagens.size();
+    vector<double> sse(K, 0.0);
+    for (size_t i = 0; i < atribuicao.rotulos.size(); ++i) {
+        sse[atribuicao.rotulos[i]] += instancias[i].getPeso() * atribuicao.distancias[i];
+    }
+
+    int doador = -1;
+    for (size_t k = 0; k < K; ++k) {
+        if (atribuicao.contagens[k] < 2 || sse[k] <= 0.0) continue;
+        if (doador == -1 || sse[k] > sse[doador]) {
+            doador = k;
+        }
+    }
+    if (doador == -1) return false;
+
+    vector<size_t> membros;
+    size_t maisDistante = 0;
+    for (size_t i = 0; i < atribuicao.rotulos.size(); ++i) {
+        if (atribuicao.rotulos[i] != doador) continue;
+        if (membros.empty() || atribuicao.distancias[i] > atribuicao.distancias[maisDistante]) {
+            maisDistante = i;
+        }
+        membros.push_back(i);
+    }
+
+    // Membros mais próximos do novo centro do que do centroide atual mudam de cluster
+    const vector<double> centro = instancias[maisDistante].getAtributos();
+    vector<size_t> movidos;
+    vector<double> novasDistancias;
+    for (size_t i : membros) {
+        const vector<double> atributos = instancias[i].getAtributos();
+        double distancia = 0.0;
+        for (size_t j = 0; j < centro.size(); ++j) {
+            double diferenca = atributos[j] - centro[j];
+            distancia += diferenca * diferenca;
+        }
+        if (i == maisDistante || distancia < atribuicao.distancias[i]) {
+            movidos.push_back(i);
+            novasDistancias.push_back(distancia);
+        }
+    }
+
+    // O doador nunca fica vazio: nesse caso apenas o membro mais distante é movido
+    if (movidos.size() == membros.size()) {
+        movidos.assign(1, maisDistante);
+        novasDistancias.assign(1, 0.0);
+    }
+
+    for (size_t m = 0; m < movidos.size(); ++m) {
+        moverInstancia(movidos[m], vazio, instancias[movidos[m]], novasDistancias[m], atribuicao);
+    }
+    return true;
+}
+
+int repararClustersVazios(vector<Centroide>& centroides, const vector<Instancia>& instancias, Atribuicao& atribuicao,
+                          PoliticaVazio politica, uint64_t semente, uint64_t rodada) {
+    if (politica == VAZIO_REINICIAR || instancias.empty()) return 0;
+
+    const size_t K = centroides.size();
+    const size_t d = atribuicao.somas.size() / K;
+    int reparados = 0;
+
+    for (size_t k = 0; k < K; ++k) {
+        if (atribuicao.contagens[k] > 0) continue;
+
+        if (politica == VAZIO_DIVIDIR_MAIOR_SSE) {
+            if (!dividirMaiorSse(k, instancias, atribuicao)) continue;
+        } else {
+            long escolhida;
+            if (politica == VAZIO_KMEANSPP) {
+                GeradorAleatorio gerador(semente, FLUXO_VAZIO + rodada * K + k);
+                escolhida = instanciaSorteada(instancias, atribuicao, gerador);
+            } else {
+                escolhida = instanciaMaisDistante(atribuicao);
+            }
+            if (escolhida == -1) continue;
+
+            moverInstancia(escolhida, k, instancias[escolhida], 0.0, atribuicao);
+        }
+
+        posicionarCentroide(centroides[k], k, atribuicao, d);
+        reparados++;
+    }
+
+    return reparados;
+}